@@ -11,46 +11,18 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <boost/container_hash/hash.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/multiprecision/cpp_dec_float.hpp>
+#include "BillLine.h"
+#include "BillLineStore.h"
 #include "Money.h"
+#include "Roster.h"
 
 namespace splitbill {
 
-/**
- * Bill Line
- */
-struct BillLine {
-  std::string name;
-  std::string description;
-  double tax_rate = 0;
-  Money amount;
-  bool split = true;
-
-  explicit BillLine(const Currency::Info &currency) :
-      amount(0, currency) {}
-
-  explicit BillLine(Currency::Code currency) :
-      amount(0, currency) {}
-
-  explicit BillLine(const std::string &currency) :
-      amount(0, currency) {}
-
-  BillLine(const BillLine &other) = default;
-
-  bool operator==(const BillLine &rhs) const {
-    return name == rhs.name &&
-        description == rhs.description &&
-        tax_rate == rhs.tax_rate &&
-        amount == rhs.amount &&
-        split == rhs.split;
-  }
-
-  bool operator!=(const BillLine &rhs) const {
-    return !(rhs == *this);
-  }
-};
-
 /**
  * Bill, post split
  */
@@ -66,8 +38,8 @@ class SplitBill {
   [[nodiscard]] Money GetTotal() const { return GetUsageTotal() + GetGeneralTotal(); }
 
  private:
-  const Money usageTotal_;
-  const Money generalTotal_;
+  Money usageTotal_;
+  Money generalTotal_;
 };
 
 /**
@@ -78,9 +50,19 @@ class BillPortion : public SplitBill {
   explicit BillPortion(std::string name, const Money &usage_total, const Money &general_total) :
       SplitBill(usage_total, general_total), name_(std::move(name)) {}
 
+  explicit BillPortion(PersonId person_id, std::string name, const Money &usage_total, const Money &general_total) :
+      SplitBill(usage_total, general_total), person_id_(person_id), name_(std::move(name)) {}
+
+  /**
+   * The person's ID in the roster the bill was split with.
+   * @return
+   */
+  [[nodiscard]] PersonId GetPersonId() const { return person_id_; }
+
   [[nodiscard]] const std::string &GetName() const { return name_; }
 
  private:
+  PersonId person_id_ = kNoPersonId;
   std::string name_;
 };
 
@@ -118,7 +100,22 @@ class PersonPeriod {
 
   [[nodiscard]] const std::string &GetName() const { return name_; }
 
-  void SetName(const std::string &name) { name_ = name; }
+  /**
+   * Set the name.  This clears the person ID, which belonged to the old name.
+   * @param name
+   */
+  void SetName(const std::string &name) {
+    name_ = name;
+    person_id_ = kNoPersonId;
+  }
+
+  /**
+   * The person's ID in a Roster, if one has been assigned.  Split() uses this instead of looking up the name.
+   * @return
+   */
+  [[nodiscard]] PersonId GetPersonId() const { return person_id_; }
+
+  void SetPersonId(PersonId person_id) { person_id_ = person_id; }
 
   [[nodiscard]] const boost::gregorian::date_period &GetPeriod() const { return period_; }
 
@@ -137,11 +134,83 @@ class PersonPeriod {
                                             boost::gregorian::from_string(end) + boost::gregorian::date_duration(1));
   }
 
+  /**
+   * Hash of the period's contents.  Equal periods have equal hashes.
+   * @return
+   */
+  [[nodiscard]] std::size_t GetHash() const {
+    std::size_t hash = 0;
+    boost::hash_combine(hash, name_);
+    boost::hash_combine(hash, person_id_);
+    boost::hash_combine(hash, period_.begin().day_number());
+    boost::hash_combine(hash, period_.end().day_number());
+    return hash;
+  }
+
+  bool operator==(const PersonPeriod &rhs) const {
+    return name_ == rhs.name_ &&
+        person_id_ == rhs.person_id_ &&
+        period_ == rhs.period_;
+  }
+
+  bool operator!=(const PersonPeriod &rhs) const {
+    return !(rhs == *this);
+  }
+
  private:
   std::string name_;
+  PersonId person_id_ = kNoPersonId;
   boost::gregorian::date_period period_;
 };
 
+/**
+ * Associate a person with the time they were present, for bills split finer than a day.
+ */
+class PersonTimePeriod {
+ public:
+  /**
+   * Create a new PersonTimePeriod for <name> present for <period>.
+   *
+   * @param name
+   * @param period
+   */
+  explicit PersonTimePeriod(std::string name, const boost::posix_time::time_period &period) :
+      name_(std::move(name)), period_(period) {}
+
+  /**
+   * Create a new PersonTimePeriod covering the whole days of <person_period>.
+   * @param person_period
+   */
+  explicit PersonTimePeriod(const PersonPeriod &person_period) :
+      name_(person_period.GetName()), person_id_(person_period.GetPersonId()),
+      period_(boost::posix_time::ptime(person_period.GetPeriod().begin()),
+              boost::posix_time::ptime(person_period.GetPeriod().end())) {}
+
+  [[nodiscard]] const std::string &GetName() const { return name_; }
+
+  /**
+   * Set the name.  This clears the person ID, which belonged to the old name.
+   * @param name
+   */
+  void SetName(const std::string &name) {
+    name_ = name;
+    person_id_ = kNoPersonId;
+  }
+
+  [[nodiscard]] PersonId GetPersonId() const { return person_id_; }
+
+  void SetPersonId(PersonId person_id) { person_id_ = person_id; }
+
+  [[nodiscard]] const boost::posix_time::time_period &GetPeriod() const { return period_; }
+
+  void SetPeriod(const boost::posix_time::time_period &period) { period_ = period; }
+
+ private:
+  std::string name_;
+  PersonId person_id_ = kNoPersonId;
+  boost::posix_time::time_period period_;
+};
+
 /**
  * Validation errors
  */
@@ -150,26 +219,68 @@ enum class ValidationError {
   kLineSumNotTotal,
 };
 
+/**
+ * How usage is divided over the billing period
+ */
+enum class SplitMode {
+  /**
+   * Count occupancy for every day of the period.
+   */
+  kDaily,
+  /**
+   * Count occupancy between period starts and ends; cost depends only on the number of periods.
+   */
+  kInterval,
+  /**
+   * Count occupancy for every day of the period from bitsets of who is present, and sum each share from those bitsets.
+   */
+  kPresenceCalendar,
+};
+
+/**
+ * Options for Bill::Split
+ */
+struct SplitOptions {
+  SplitMode mode = SplitMode::kInterval;
+  /**
+   * Number of threads to split with; 0 uses one per core.  Results are identical regardless of thread count.
+   */
+  unsigned int threads = 1;
+};
+
 /**
  * Bill
  */
 class Bill {
  public:
   explicit Bill(const Currency::Info &currency) :
-      total_amount_(0, currency) {}
+      Bill(currency.code) {}
 
   explicit Bill(Currency::Code currency) :
-      total_amount_(0, currency) {}
+      total_amount_(0, currency), lines_(currency), usage_total_(0, currency), general_total_(0, currency) {}
 
   explicit Bill(const std::string &currency) :
-      total_amount_(0, currency) {}
+      Bill(Currency::Get(currency).code) {}
 
   /**
    * Tote the bill
    *
+   * The totals are kept up to date as lines change, so this is O(1).  Lines are summed untaxed by tax rate and each
+   * rate's tax is applied to its sum, so an edit costs one tax calculation however many lines share its rate.
+   *
    * @return
    */
-  [[nodiscard]] SplitBill Total();
+  [[nodiscard]] SplitBill Total() const;
+
+  /**
+   * Tote the bill from its lines instead of the running totals.  The result is the same as Total().
+   *
+   * Each tax rate's lines are summed straight from the line store's columns, with SIMD instructions when the processor
+   * has them.
+   *
+   * @return
+   */
+  [[nodiscard]] SplitBill TotalLines() const;
 
   /**
    * Split the bill according to period.
@@ -180,7 +291,83 @@ class Bill {
    */
   [[nodiscard]] std::vector<splitbill::BillPortion> Split(const boost::gregorian::date_period &period,
                                                           const std::vector<PersonPeriod> &person_periods,
-                                                          const std::vector<std::string> &people);
+                                                          const std::vector<std::string> &people) const {
+    return Split(period, person_periods, people, SplitOptions());
+  }
+
+  /**
+   * Split the bill according to period.
+   *
+   * @param period
+   * @param person_periods
+   * @param people
+   * @param options
+   * @return
+   */
+  [[nodiscard]] std::vector<splitbill::BillPortion> Split(const boost::gregorian::date_period &period,
+                                                          const std::vector<PersonPeriod> &person_periods,
+                                                          const std::vector<std::string> &people,
+                                                          const SplitOptions &options) const {
+    return Split(period, person_periods, Roster(people), options);
+  }
+
+  /**
+   * Split the bill among the people in <roster>.
+   *
+   * Periods with a person ID are matched by ID, which must come from <roster>; other periods are matched by name.
+   * Portions are returned in roster order.
+   *
+   * @param period
+   * @param person_periods
+   * @param roster
+   * @param options
+   * @return
+   */
+  [[nodiscard]] std::vector<splitbill::BillPortion> Split(const boost::gregorian::date_period &period,
+                                                          const std::vector<PersonPeriod> &person_periods,
+                                                          const Roster &roster,
+                                                          const SplitOptions &options = SplitOptions()) const;
+
+  /**
+   * Split the bill among the people in <roster>, by time present instead of days present.
+   *
+   * Usage is divided into units of <resolution>, and any part of a unit present counts as the whole unit.  Only period
+   * starts and ends are visited, so a fine resolution costs no more than a coarse one.  Whole-day periods at a
+   * resolution of 24 hours split the same as Split() with dates.  The split mode in <options> is not used.
+   *
+   * @param period
+   * @param person_periods
+   * @param roster
+   * @param resolution Must be positive.
+   * @param options
+   * @return
+   */
+  [[nodiscard]] std::vector<splitbill::BillPortion> Split(const boost::posix_time::time_period &period,
+                                                          const std::vector<PersonTimePeriod> &person_periods,
+                                                          const Roster &roster,
+                                                          const boost::posix_time::time_duration &resolution
+                                                          = boost::posix_time::hours(1),
+                                                          const SplitOptions &options = SplitOptions()) const;
+
+  /**
+   * Split several bills over the same period among the same people.
+   *
+   * Who is present when is only worked out once for the whole batch.  Each bill's portions are identical to what
+   * Split() would return for it.
+   *
+   * @param bills
+   * @param period
+   * @param person_periods
+   * @param roster
+   * @param options
+   * @return The portions of each bill, in the order of <bills>.
+   */
+  [[nodiscard]] static std::vector<std::vector<splitbill::BillPortion>> SplitAll(
+      const std::vector<Bill> &bills,
+      const boost::gregorian::date_period &period,
+      const std::vector<PersonPeriod> &person_periods,
+      const Roster &roster,
+      const SplitOptions &options = SplitOptions());
 
   /**
    * Split the bill according to period.
@@ -192,7 +379,7 @@ class Bill {
   [[nodiscard]] std::vector<splitbill::BillPortion> Split(const std::string &start,
                                                           const std::string &end,
                                                           const std::vector<PersonPeriod> &person_periods,
-                                                          const std::vector<std::string> &people) {
+                                                          const std::vector<std::string> &people) const {
     const boost::date_time::period<boost::gregorian::date, boost::gregorian::date_duration>
         period(boost::gregorian::from_string(start),
                boost::gregorian::from_string(end) + boost::gregorian::date_duration(1));
@@ -206,7 +393,7 @@ class Bill {
    * @param error
    * @return
    */
-  [[nodiscard]] bool IsValid(ValidationError &error);
+  [[nodiscard]] bool IsValid(ValidationError &error) const;
 
   [[nodiscard]] const Currency::Info &GetCurrency() const {
     return total_amount_.GetCurrency();
@@ -218,49 +405,177 @@ class Bill {
 
   void SetTotalAmount(const Money &total_amount) {
     total_amount_ = total_amount;
+    version_++;
   }
 
-  [[nodiscard]] const std::vector<BillLine> &GetLines() const {
-    return lines_;
+  /**
+   * A counter that changes every time the bill is modified.
+   *
+   * Callers can remember the version they last saw to skip work when nothing has changed.
+   *
+   * @return
+   */
+  [[nodiscard]] std::uint64_t GetVersion() const {
+    return version_;
   }
 
-  [[nodiscard]] const BillLine &GetLine(const size_t &pos) const {
-    return lines_.at(pos);
-  }
+  /**
+   * Defer updating the totals and hashes until the matching Commit().
+   *
+   * Lines can be edited as usual in between, but Total(), Split(), and the hash functions see stale values until the
+   * outermost batch is committed.  Batches nest.
+   */
+  void BeginBatch();
 
-  [[nodiscard]] size_t GetLineCount() const {
-    return lines_.size();
-  }
+  /**
+   * End a batch started with BeginBatch().  Ending the outermost batch retaxes each rate and rehashes the edited
+   * lines once.
+   */
+  void Commit();
 
-  void AddLine(const BillLine &line, const size_t &pos) {
-    lines_.insert(lines_.cbegin() + pos, line);
+  [[nodiscard]] bool IsBatching() const {
+    return batch_depth_ > 0;
   }
 
-  void AddLine(const BillLine &line) {
-    lines_.push_back(line);
+  /**
+   * Batches the bill's edits for as long as it exists.
+   */
+  class Batch {
+   public:
+    explicit Batch(Bill &bill) :
+        bill_(bill) {
+      bill_.BeginBatch();
+    }
+
+    Batch(const Batch &) = delete;
+
+    Batch &operator=(const Batch &) = delete;
+
+    ~Batch() {
+      bill_.Commit();
+    }
+
+   private:
+    Bill &bill_;
+  };
+
+  /**
+   * Hash of the bill's total and lines.  Equal bills have equal hashes.
+   *
+   * Lines are hashed as they change and combined in a Merkle tree, so this is O(1).
+   *
+   * @return
+   */
+  [[nodiscard]] std::size_t GetHash() const;
+
+  /**
+   * Hash of the line at <pos>, the same as GetLine(<pos>).GetHash().
+   * @param pos
+   * @return
+   */
+  [[nodiscard]] std::size_t GetLineHash(const size_t &pos) const {
+    return line_hash_tree_.front().at(pos);
   }
 
-  void RemoveLine(const size_t &pos) {
-    lines_.erase(lines_.cbegin() + pos);
+  /**
+   * Positions where this bill's lines differ from <other>'s, in order.
+   *
+   * If both bills have the same number of lines, only the branches of the Merkle tree that differ are visited, so this
+   * is O(changed lines * log lines).  Otherwise each position's hash is compared, and positions past the end of the
+   * shorter bill are all different.
+   *
+   * @param other
+   * @return
+   */
+  [[nodiscard]] std::vector<size_t> GetChangedLines(const Bill &other) const;
+
+  /**
+   * Copies of all lines.  Prefer GetLineStore() to read many lines.
+   * @return
+   */
+  [[nodiscard]] std::vector<BillLine> GetLines() const;
+
+  /**
+   * A copy of the line at <pos>, assembled from the line store.
+   * @param pos
+   * @return
+   */
+  [[nodiscard]] BillLine GetLine(const size_t &pos) const {
+    return lines_.Get(pos);
   }
 
-  void RemoveLine(const BillLine &line) {
-    lines_.erase(std::remove(lines_.begin(), lines_.end(), line));
+  /**
+   * The lines, stored by column
+   * @return
+   */
+  [[nodiscard]] const BillLineStore &GetLineStore() const {
+    return lines_;
   }
 
-  void UpdateLine(const size_t &pos, const BillLine &line) {
-    lines_[pos] = line;
+  [[nodiscard]] size_t GetLineCount() const {
+    return lines_.GetCount();
   }
 
+  void AddLine(const BillLine &line, const size_t &pos);
+
+  void AddLine(const BillLine &line);
+
+  /**
+   * Insert <lines> before <pos>, in order, shifting the later lines once.
+   * @param lines
+   * @param pos
+   */
+  void InsertLines(const std::vector<BillLine> &lines, const size_t &pos);
+
+  void RemoveLine(const size_t &pos);
+
+  /**
+   * Remove the lines at <positions> in a single pass.
+   * @param positions Sorted, without repeats.
+   */
+  void RemoveLines(const std::vector<size_t> &positions);
+
+  /**
+   * Remove all lines equal to <line>.
+   * @param line
+   */
+  void RemoveLine(const BillLine &line);
+
+  void UpdateLine(const size_t &pos, const BillLine &line);
+
  private:
   Money total_amount_;
-  std::vector<BillLine> lines_;
-
-  static std::vector<Money> GetAmounts(const std::vector<BillLine> &lines);
-  static std::vector<BillLine> ApplyTax(const std::vector<BillLine> &lines);
-  static void SortLinesBySplit(const std::vector<BillLine> &lines,
-                               std::vector<BillLine> &split_lines,
-                               std::vector<BillLine> &not_split_lines);
+  BillLineStore lines_;
+  /**
+   * Lines with the same tax rate
+   */
+  struct TaxBucket {
+    TaxRate tax_rate;
+    size_t line_count;
+    Money untaxed_usage;
+    Money untaxed_general;
+    Money usage;
+    Money general;
+  };
+  std::vector<TaxBucket> tax_buckets_;
+  // Sums of the taxed buckets
+  Money usage_total_;
+  Money general_total_;
+  std::uint64_t version_ = 0;
+  // Merkle tree of line hashes; the first level has one hash per line and the last level is the root.
+  std::vector<std::vector<std::size_t>> line_hash_tree_ = {{}};
+  unsigned int batch_depth_ = 0;
+  // Line hashes edited during the current batch, as [first, last)
+  size_t rehash_first_ = 0;
+  size_t rehash_last_ = 0;
+
+  void AddToTotals(const Money &amount, TaxRate tax_rate, bool split);
+  void RemoveFromTotals(const Money &amount, TaxRate tax_rate, bool split);
+  void RetaxBucket(TaxBucket &bucket, bool split);
+  /**
+   * Recompute the Merkle tree nodes above the line hashes in [<first>, <last>).
+   */
+  void RehashLineTree(size_t first, size_t last);
 };
 
 } // splitbill
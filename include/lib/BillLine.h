@@ -0,0 +1,83 @@
+/**
+ * @file BillLine.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_BILLLINE_H_
+#define SPLITBILL_INCLUDE_LIB_BILLLINE_H_
+
+#include <cstddef>
+#include <string>
+#include <boost/container_hash/hash.hpp>
+#include "Money.h"
+#include "TaxRate.h"
+
+namespace splitbill {
+
+/**
+ * Bill Line
+ *
+ * Lines keep their own text rather than StringPool IDs: a line is a free-standing value that is built by the UI,
+ * copied between bills, and compared with lines from other bills, and an ID only means something inside one pool.  So
+ * operator==() compares strings.  Comparisons against lines already in a bill go through BillLineStore::Equals(), which
+ * compares the interned IDs instead.
+ */
+struct BillLine {
+  std::string name;
+  std::string description;
+  TaxRate tax_rate;
+  Money amount;
+  bool split = true;
+
+  explicit BillLine(const Currency::Info &currency) :
+      amount(0, currency) {}
+
+  explicit BillLine(Currency::Code currency) :
+      amount(0, currency) {}
+
+  explicit BillLine(const std::string &currency) :
+      amount(0, currency) {}
+
+  BillLine(const BillLine &other) = default;
+
+  /**
+   * The line amount with tax applied
+   * @return
+   */
+  [[nodiscard]] Money GetTaxedAmount() const {
+    return tax_rate.Apply(amount);
+  }
+
+  /**
+   * Hash of the line's contents.  Equal lines have equal hashes.
+   * @return
+   */
+  [[nodiscard]] std::size_t GetHash() const {
+    std::size_t hash = 0;
+    boost::hash_combine(hash, name);
+    boost::hash_combine(hash, description);
+    boost::hash_combine(hash, tax_rate.GetMillionths());
+    boost::hash_combine(hash, amount.GetHash());
+    boost::hash_combine(hash, split);
+    return hash;
+  }
+
+  bool operator==(const BillLine &rhs) const {
+    return name == rhs.name &&
+        description == rhs.description &&
+        tax_rate == rhs.tax_rate &&
+        amount == rhs.amount &&
+        split == rhs.split;
+  }
+
+  bool operator!=(const BillLine &rhs) const {
+    return !(rhs == *this);
+  }
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_BILLLINE_H_
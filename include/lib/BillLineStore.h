@@ -0,0 +1,139 @@
+/**
+ * @file BillLineStore.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_BILLLINESTORE_H_
+#define SPLITBILL_INCLUDE_LIB_BILLLINESTORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BillLine.h"
+#include "Money.h"
+#include "StringPool.h"
+#include "TaxRate.h"
+
+namespace splitbill {
+
+/**
+ * Bill lines stored by column.
+ *
+ * Amounts, tax rates, and split flags each sit in their own contiguous array, and the split flags are packed 64 to a
+ * word.  Totals and filters only stream through the columns they need.  Names and descriptions are interned in the
+ * store's StringPool, so their columns hold small IDs and repeated text is stored once.  Each line holds a reference to
+ * its text, released when the line is changed or erased.  All amounts share the store's currency.
+ */
+class BillLineStore {
+ public:
+  explicit BillLineStore(Currency::Code currency) :
+      currency_(currency) {}
+
+  [[nodiscard]] Currency::Code GetCurrencyCode() const { return currency_; }
+
+  [[nodiscard]] std::size_t GetCount() const { return amounts_.size(); }
+
+  /**
+   * Assemble the line at <pos> from its columns.
+   * @param pos
+   * @return
+   */
+  [[nodiscard]] BillLine Get(std::size_t pos) const;
+
+  /**
+   * Does the line at <pos> equal <line>?  The cheapest columns are compared first.
+   * @param pos
+   * @param line
+   * @return
+   */
+  [[nodiscard]] bool Equals(std::size_t pos, const BillLine &line) const;
+
+  [[nodiscard]] const std::string &GetName(std::size_t pos) const { return strings_.Get(names_.at(pos)); }
+
+  [[nodiscard]] const std::string &GetDescription(std::size_t pos) const {
+    return strings_.Get(descriptions_.at(pos));
+  }
+
+  /**
+   * Name column, as IDs in GetStrings()
+   * @return
+   */
+  [[nodiscard]] const std::vector<StringId> &GetNameIds() const { return names_; }
+
+  /**
+   * Description column, as IDs in GetStrings()
+   * @return
+   */
+  [[nodiscard]] const std::vector<StringId> &GetDescriptionIds() const { return descriptions_; }
+
+  /**
+   * Every name and description the store's lines use
+   * @return
+   */
+  [[nodiscard]] const StringPool &GetStrings() const { return strings_; }
+
+  [[nodiscard]] Money GetAmount(std::size_t pos) const { return Money::FromDecimal(amounts_.at(pos), currency_); }
+
+  [[nodiscard]] TaxRate GetTaxRate(std::size_t pos) const { return tax_rates_.at(pos); }
+
+  [[nodiscard]] bool IsSplit(std::size_t pos) const {
+    return (split_bits_.at(pos / kWordBits) >> (pos % kWordBits)) & 1;
+  }
+
+  /**
+   * Amount column, in the store's currency
+   * @return
+   */
+  [[nodiscard]] const std::vector<Money::Decimal> &GetAmounts() const { return amounts_; }
+
+  [[nodiscard]] const std::vector<TaxRate> &GetTaxRates() const { return tax_rates_; }
+
+  /**
+   * Split flags, one bit per line; bit <pos> % 64 of word <pos> / 64.  Bits past the last line are zero.
+   * @return
+   */
+  [[nodiscard]] const std::vector<std::uint64_t> &GetSplitBits() const { return split_bits_; }
+
+  /**
+   * @param pos
+   * @param line Must be in the store's currency.
+   */
+  void Insert(std::size_t pos, const BillLine &line);
+
+  /**
+   * Insert several lines before <pos> in one pass.
+   * @param pos
+   * @param lines Must all be in the store's currency.
+   */
+  void Insert(std::size_t pos, const std::vector<BillLine> &lines);
+
+  void Set(std::size_t pos, const BillLine &line);
+
+  void Erase(std::size_t pos);
+
+  /**
+   * Erase several lines in one pass.
+   * @param positions Sorted, without repeats.
+   */
+  void Erase(const std::vector<std::size_t> &positions);
+
+ private:
+  static constexpr std::size_t kWordBits = 64;
+
+  Currency::Code currency_;
+  std::vector<Money::Decimal> amounts_;
+  std::vector<TaxRate> tax_rates_;
+  std::vector<std::uint64_t> split_bits_;
+  std::vector<StringId> names_;
+  std::vector<StringId> descriptions_;
+  StringPool strings_;
+
+  void SetSplit(std::size_t pos, bool split);
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_BILLLINESTORE_H_
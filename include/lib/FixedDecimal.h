@@ -0,0 +1,180 @@
+/**
+ * @file FixedDecimal.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_FIXEDDECIMAL_H_
+#define SPLITBILL_INCLUDE_LIB_FIXEDDECIMAL_H_
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#ifndef __SIZEOF_INT128__
+#include <boost/multiprecision/cpp_int.hpp>
+#endif
+
+namespace splitbill {
+
+/**
+ * Decimal number stored as a 64-bit integer count of billionths.
+ *
+ * This is much finer than the minor unit of any currency, so values round the same way as they would with
+ * arbitrary-precision decimals while every operation stays in plain integer arithmetic.  Products and quotients are
+ * computed in 128 bits and rounded half away from zero.  The representable range is about +/- 9.2 billion; results
+ * outside it throw std::overflow_error.
+ */
+class FixedDecimal {
+ public:
+  static constexpr unsigned int kDigits = 9;
+  static constexpr std::int64_t kScale = 1'000'000'000;
+
+  constexpr FixedDecimal() = default;
+
+  FixedDecimal(double value) :
+      raw_(FromDouble(value)) {}
+
+  constexpr FixedDecimal(int value) :
+      raw_(value * kScale) {}
+
+  /**
+   * Create a value from its raw count of billionths.
+   * @param raw
+   * @return
+   */
+  [[nodiscard]] static constexpr FixedDecimal FromRaw(std::int64_t raw) {
+    FixedDecimal value;
+    value.raw_ = raw;
+    return value;
+  }
+
+  [[nodiscard]] constexpr std::int64_t GetRaw() const { return raw_; }
+
+  [[nodiscard]] double ToDouble() const {
+    return static_cast<double>(raw_) / kScale;
+  }
+
+  /**
+   * Round to the nearest 1/<multiplier>, half away from zero.
+   *
+   * @param multiplier
+   * @return The number of 1/<multiplier> units.
+   */
+  [[nodiscard]] std::int64_t Round(std::int64_t multiplier) const {
+    return Narrow(DivideRounded(Wide(raw_) * multiplier, kScale));
+  }
+
+  /**
+   * Multiply by <numerator> / <denominator>, rounding only once.
+   *
+   * @param numerator
+   * @param denominator Must not be zero.
+   * @return
+   */
+  [[nodiscard]] FixedDecimal Scale(std::int64_t numerator, std::int64_t denominator) const {
+    if (denominator == 0) {
+      throw std::domain_error("Division by zero");
+    }
+    return FromRaw(Narrow(DivideRounded(Wide(raw_) * numerator, denominator)));
+  }
+
+  [[nodiscard]] constexpr bool operator==(const FixedDecimal &rhs) const { return raw_ == rhs.raw_; }
+  [[nodiscard]] constexpr bool operator!=(const FixedDecimal &rhs) const { return raw_ != rhs.raw_; }
+  [[nodiscard]] constexpr bool operator<(const FixedDecimal &rhs) const { return raw_ < rhs.raw_; }
+  [[nodiscard]] constexpr bool operator>(const FixedDecimal &rhs) const { return raw_ > rhs.raw_; }
+  [[nodiscard]] constexpr bool operator<=(const FixedDecimal &rhs) const { return raw_ <= rhs.raw_; }
+  [[nodiscard]] constexpr bool operator>=(const FixedDecimal &rhs) const { return raw_ >= rhs.raw_; }
+
+  [[nodiscard]] constexpr FixedDecimal operator+(const FixedDecimal &rhs) const { return FromRaw(Add(raw_, rhs.raw_)); }
+  [[nodiscard]] constexpr FixedDecimal operator-(const FixedDecimal &rhs) const {
+    return FromRaw(Subtract(raw_, rhs.raw_));
+  }
+
+  [[nodiscard]] FixedDecimal operator*(const FixedDecimal &rhs) const {
+    return FromRaw(Narrow(DivideRounded(Wide(raw_) * rhs.raw_, kScale)));
+  }
+
+  [[nodiscard]] FixedDecimal operator/(const FixedDecimal &rhs) const {
+    if (rhs.raw_ == 0) {
+      throw std::domain_error("Division by zero");
+    }
+    return FromRaw(Narrow(DivideRounded(Wide(raw_) * kScale, rhs.raw_)));
+  }
+
+ private:
+#ifdef __SIZEOF_INT128__
+  __extension__ typedef __int128 Wide;
+#else
+  using Wide = boost::multiprecision::int128_t;
+#endif
+
+  std::int64_t raw_ = 0;
+
+  static constexpr std::int64_t Add(std::int64_t lhs, std::int64_t rhs) {
+    std::int64_t result = 0;
+#if defined(__GNUC__) || defined(__clang__)
+    if (__builtin_add_overflow(lhs, rhs, &result)) {
+      throw std::overflow_error("Decimal value out of range");
+    }
+#else
+    if ((rhs > 0 && lhs > std::numeric_limits<std::int64_t>::max() - rhs)
+        || (rhs < 0 && lhs < std::numeric_limits<std::int64_t>::min() - rhs)) {
+      throw std::overflow_error("Decimal value out of range");
+    }
+    result = lhs + rhs;
+#endif
+    return result;
+  }
+
+  static constexpr std::int64_t Subtract(std::int64_t lhs, std::int64_t rhs) {
+    std::int64_t result = 0;
+#if defined(__GNUC__) || defined(__clang__)
+    if (__builtin_sub_overflow(lhs, rhs, &result)) {
+      throw std::overflow_error("Decimal value out of range");
+    }
+#else
+    if ((rhs < 0 && lhs > std::numeric_limits<std::int64_t>::max() + rhs)
+        || (rhs > 0 && lhs < std::numeric_limits<std::int64_t>::min() + rhs)) {
+      throw std::overflow_error("Decimal value out of range");
+    }
+    result = lhs - rhs;
+#endif
+    return result;
+  }
+
+  static std::int64_t FromDouble(double value) {
+    const double scaled = value * kScale;
+    // 2^63 is exact as a double; the comparisons also reject NaN.
+    constexpr double kLimit = 9223372036854775808.0;
+    if (!(scaled >= -kLimit && scaled < kLimit)) {
+      throw std::overflow_error("Decimal value out of range");
+    }
+    return std::llround(scaled);
+  }
+
+  static std::int64_t Narrow(const Wide &value) {
+    if (value > Wide(std::numeric_limits<std::int64_t>::max())
+        || value < Wide(std::numeric_limits<std::int64_t>::min())) {
+      throw std::overflow_error("Decimal value out of range");
+    }
+    return static_cast<std::int64_t>(value);
+  }
+
+  static Wide DivideRounded(const Wide &numerator, const Wide &denominator) {
+    Wide quotient = numerator / denominator;
+    const Wide remainder = numerator - quotient * denominator;
+    const Wide twice_remainder = remainder < 0 ? remainder * -2 : remainder * 2;
+    const Wide abs_denominator = denominator < 0 ? -denominator : denominator;
+    if (twice_remainder >= abs_denominator) {
+      quotient += ((numerator < 0) != (denominator < 0)) ? -1 : 1;
+    }
+    return quotient;
+  }
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_FIXEDDECIMAL_H_
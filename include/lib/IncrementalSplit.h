@@ -0,0 +1,102 @@
+/**
+ * @file IncrementalSplit.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_INCREMENTALSPLIT_H_
+#define SPLITBILL_INCLUDE_LIB_INCREMENTALSPLIT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "Bill.h"
+#include "Occupancy.h"
+#include "Roster.h"
+
+namespace splitbill {
+
+/**
+ * A bill split that is kept up to date as presence periods are edited.
+ *
+ * Daily occupancy and each person's usage are kept between edits.  Changing one period only revisits the days it
+ * gained or lost and the periods present on those days, instead of splitting the whole bill again.  Days are costed
+ * one at a time, so portions are exactly what Bill::Split() returns for the current periods with SplitMode::kDaily.
+ * Other modes round multi-day segments on their own and can differ from it in the last digit.
+ */
+class IncrementalSplit {
+ public:
+  explicit IncrementalSplit(const Bill &bill,
+                            const boost::gregorian::date_period &period,
+                            std::vector<PersonPeriod> person_periods,
+                            Roster roster);
+
+  /**
+   * Split a bill from just its totals, so callers needn't keep a copy of its lines.
+   * @param totals The bill's Total()
+   * @param currency The bill's currency
+   * @param period
+   * @param person_periods
+   * @param roster
+   */
+  explicit IncrementalSplit(const SplitBill &totals,
+                            Currency::Code currency,
+                            const boost::gregorian::date_period &period,
+                            std::vector<PersonPeriod> person_periods,
+                            Roster roster);
+
+  /**
+   * Use new totals for the bill.  This recomputes everyone's usage.
+   * @param totals The bill's Total()
+   * @param currency The bill's currency
+   */
+  void SetBill(const SplitBill &totals, Currency::Code currency);
+
+  /**
+   * Replace the period at <pos>.  The person may change as well as the dates.
+   * @param pos
+   * @param person_period
+   */
+  void UpdatePersonPeriod(std::size_t pos, const PersonPeriod &person_period);
+
+  [[nodiscard]] const std::vector<PersonPeriod> &GetPersonPeriods() const { return person_periods_; }
+
+  [[nodiscard]] const Roster &GetRoster() const { return roster_; }
+
+  [[nodiscard]] const boost::gregorian::date_period &GetPeriod() const { return period_; }
+
+  /**
+   * Each person's portion of the bill, in roster order.
+   * @return
+   */
+  [[nodiscard]] std::vector<BillPortion> GetPortions() const;
+
+ private:
+  boost::gregorian::date_period period_;
+  std::vector<PersonPeriod> person_periods_;
+  Roster roster_;
+  // Clipped day offsets and roster ID of each period
+  std::vector<Offsets> offsets_;
+  std::vector<PersonId> person_ids_;
+  Money usage_total_;
+  Money general_total_;
+  // Number of periods present on each day
+  std::vector<unsigned int> occupancy_;
+  std::int64_t empty_days_ = 0;
+  // The cost of one day shared by each number of people
+  std::vector<Money> part_costs_;
+  // Each person's usage of days they were present
+  std::vector<Money> present_usages_;
+
+  [[nodiscard]] PersonId GetPersonId(const PersonPeriod &person_period) const;
+  [[nodiscard]] std::int64_t GetDayCount() const;
+  [[nodiscard]] Money GetPartCost(unsigned int parts);
+  void Build();
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_INCREMENTALSPLIT_H_
@@ -0,0 +1,71 @@
+/**
+ * @file LineKernels.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_LINEKERNELS_H_
+#define SPLITBILL_INCLUDE_LIB_LINEKERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "FixedDecimal.h"
+#include "TaxRate.h"
+
+namespace splitbill {
+
+/**
+ * Instruction sets the line kernels can use, from least to most capable
+ */
+enum class SimdLevel {
+  kScalar = 0,
+  kSse41,
+  kAvx2,
+};
+
+/**
+ * The most capable instruction set this processor supports.  Checked once.
+ * @return
+ */
+[[nodiscard]] SimdLevel GetSimdLevel();
+
+/**
+ * Sums of the lines with one tax rate
+ */
+struct LineSums {
+  // Raw fixed-point sums of split and unsplit line amounts
+  std::int64_t usage = 0;
+  std::int64_t general = 0;
+  std::size_t line_count = 0;
+};
+
+/**
+ * Sum the amounts of the lines taxed at each of <rates>, separately for split and unsplit lines.
+ *
+ * Lines are copied out of the columns a block at a time, and up to four rates are summed in each pass over a block.
+ * Every level gives exactly the same result.
+ *
+ * @param amounts Amount column
+ * @param tax_rates Tax rate column
+ * @param split_bits Split flags, one bit per line
+ * @param count Number of lines
+ * @param rates Rates to sum
+ * @param sums Receives the sums for each of <rates>
+ * @param rate_count Number of <rates> and <sums>
+ * @param level Must be supported by this processor.
+ * @throw std::overflow_error if a sum doesn't fit in a FixedDecimal, the same as Money would.
+ */
+void SumLinesByTaxRate(const FixedDecimal *amounts,
+                       const TaxRate *tax_rates,
+                       const std::uint64_t *split_bits,
+                       std::size_t count,
+                       const TaxRate *rates,
+                       LineSums *sums,
+                       std::size_t rate_count,
+                       SimdLevel level = GetSimdLevel());
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_LINEKERNELS_H_
@@ -9,28 +9,62 @@
 #ifndef SPLITBILL_INCLUDE_LIB_MONEY_H_
 #define SPLITBILL_INCLUDE_LIB_MONEY_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#ifdef SPLITBILL_MONEY_DECIMAL
 #include <boost/multiprecision/cpp_dec_float.hpp>
+#else
+#include "FixedDecimal.h"
+#endif
 #include "Currency.h"
 
 namespace splitbill {
 
 /**
  * Store monetary values without floating-point math
+ *
+ * Values are stored as fixed-point integers by default.  Define SPLITBILL_MONEY_DECIMAL (the MONEY_BACKEND CMake
+ * option) to store them as 50-digit decimals instead.
  */
 class Money {
  public:
+#ifdef SPLITBILL_MONEY_DECIMAL
+  using Decimal = boost::multiprecision::number<boost::multiprecision::cpp_dec_float<50>>;
+#else
+  using Decimal = FixedDecimal;
+#endif
+
   explicit Money() = default;
 
-  explicit Money(const double &value, Currency::Info currency);
+  explicit Money(const double &value, Currency::Code currency);
 
-  explicit Money(const double &value, Currency::Code currency) :
-      Money(value, Currency::Get(currency)) {}
+  explicit Money(const double &value, const Currency::Info &currency) :
+      Money(value, currency.code) {}
 
   explicit Money(const double &value, const std::string &currency) :
       Money(value, Currency::Get(currency)) {}
 
   [[nodiscard]] double GetValue() const;
-  [[nodiscard]] const Currency::Info &GetCurrency() const;
+  [[nodiscard]] const Currency::Info &GetCurrency() const { return Currency::Get(currency_); }
+  [[nodiscard]] Currency::Code GetCurrencyCode() const { return currency_; }
+
+  /**
+   * The exact stored value, for code that keeps many amounts of one currency together.
+   * @return
+   */
+  [[nodiscard]] const Decimal &GetDecimal() const { return value_; }
+
+  [[nodiscard]] static Money FromDecimal(Decimal value, Currency::Code currency) {
+    return Money(std::move(value), currency);
+  }
+
+  /**
+   * Hash of the exact value and currency.  Equal amounts have equal hashes.
+   * @return
+   */
+  [[nodiscard]] std::size_t GetHash() const;
 
   [[nodiscard]] bool operator==(const Money &rhs) const;
   [[nodiscard]] bool operator==(double rhs) const;
@@ -54,16 +88,26 @@ class Money {
   [[nodiscard]] Money operator/(const Money &rhs) const;
   [[nodiscard]] Money operator/(double rhs) const;
 
- private:
-  using Decimal = boost::multiprecision::number<boost::multiprecision::cpp_dec_float<50>>;
+  /**
+   * Multiply by <numerator> / <denominator> without rounding the quotient first.
+   * @param numerator
+   * @param denominator
+   * @return
+   */
+  [[nodiscard]] Money Scale(std::int64_t numerator, std::int64_t denominator) const;
 
-  Currency::Info currency_ = Currency::Get(Currency::Code::USD);
+ private:
+  Currency::Code currency_ = Currency::Code::USD;
   Decimal value_ = 0;
 
-  explicit Money(Decimal value, Currency::Info currency) :
-      currency_(std::move(currency)), value_(std::move(value)) {}
+  explicit Money(Decimal value, Currency::Code currency) :
+      currency_(currency), value_(std::move(value)) {}
 };
 
+#ifndef SPLITBILL_MONEY_DECIMAL
+static_assert(std::is_trivially_copyable_v<Money>, "Money is copied around freely and must stay cheap to copy");
+#endif
+
 } // splitbill
 
 #endif //SPLITBILL_INCLUDE_LIB_MONEY_H_
@@ -0,0 +1,149 @@
+/**
+ * @file Occupancy.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_OCCUPANCY_H_
+#define SPLITBILL_INCLUDE_LIB_OCCUPANCY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace splitbill {
+
+class PersonPeriod;
+
+/**
+ * A half-open range of time units, counted from the start of a billing period.
+ */
+using Offsets = std::pair<std::int64_t, std::int64_t>;
+
+/**
+ * Clip <period> to <billing_period>.
+ *
+ * @param billing_period
+ * @param period
+ * @return The first and one-past-last day offsets covered.  These are equal if <period> is outside the billing period.
+ */
+[[nodiscard]] Offsets GetDayOffsets(const boost::gregorian::date_period &billing_period,
+                                    const boost::gregorian::date_period &period);
+
+/**
+ * Clip <period> to <billing_period>, in units of <resolution>.
+ *
+ * Any part of a unit counts as the whole unit, the same way any part of a day counts as a day present.
+ *
+ * @param billing_period
+ * @param period
+ * @param resolution Must be positive.
+ * @return The first and one-past-last units covered.  These are equal if <period> is outside the billing period.
+ */
+[[nodiscard]] Offsets GetTimeOffsets(const boost::posix_time::time_period &billing_period,
+                                     const boost::posix_time::time_period &period,
+                                     const boost::posix_time::time_duration &resolution);
+
+/**
+ * How many people are present on each day of a billing period.
+ *
+ * Built from the start and end of each presence period with a difference array, so construction is O(P + D)
+ * instead of checking every period on every day.  Each day is its own segment.
+ */
+class DayOccupancy {
+ public:
+  explicit DayOccupancy(const boost::gregorian::date_period &period, const std::vector<PersonPeriod> &person_periods);
+
+  [[nodiscard]] std::size_t GetSegmentCount() const { return occupancy_.size(); }
+
+  [[nodiscard]] std::int64_t GetSegmentLength(std::size_t /* segment */) const { return 1; }
+
+  /**
+   * Number of presence periods covering <segment>.
+   * @param segment
+   * @return
+   */
+  [[nodiscard]] unsigned int GetOccupancy(std::size_t segment) const { return occupancy_.at(segment); }
+
+  /**
+   * Number of days no one was present
+   * @return
+   */
+  [[nodiscard]] std::int64_t GetEmptyLength() const { return empty_length_; }
+
+  /**
+   * The first and one-past-last segments covered by <offsets>.
+   * @param offsets Clipped to the billing period.
+   * @return
+   */
+  [[nodiscard]] std::pair<std::size_t, std::size_t> GetSegments(const Offsets &offsets) const {
+    return {offsets.first, offsets.second};
+  }
+
+ private:
+  std::vector<unsigned int> occupancy_;
+  std::int64_t empty_length_ = 0;
+};
+
+/**
+ * How many people are present between each pair of adjacent period starts and ends.
+ *
+ * Occupancy only changes where a presence period starts or ends, so the billing period is cut at those breakpoints
+ * into segments of constant occupancy.  Construction is O(P log P) no matter how long the billing period is or how
+ * fine its units are.
+ */
+class IntervalOccupancy {
+ public:
+  /**
+   * @param length Length of the billing period, in any unit.
+   * @param intervals Presence intervals in the same unit, clipped to [0, <length>).
+   */
+  explicit IntervalOccupancy(std::int64_t length, const std::vector<Offsets> &intervals);
+
+  explicit IntervalOccupancy(const boost::gregorian::date_period &period,
+                             const std::vector<PersonPeriod> &person_periods);
+
+  [[nodiscard]] std::size_t GetSegmentCount() const { return occupancy_.size(); }
+
+  [[nodiscard]] std::int64_t GetSegmentLength(std::size_t segment) const {
+    return breakpoints_.at(segment + 1) - breakpoints_.at(segment);
+  }
+
+  /**
+   * Number of presence intervals covering <segment>.
+   * @param segment
+   * @return
+   */
+  [[nodiscard]] unsigned int GetOccupancy(std::size_t segment) const { return occupancy_.at(segment); }
+
+  /**
+   * Number of units no one was present
+   * @return
+   */
+  [[nodiscard]] std::int64_t GetEmptyLength() const { return empty_length_; }
+
+  /**
+   * The first and one-past-last segments covered by <offsets>.
+   *
+   * @param offsets Clipped to the billing period.  Both ends must be breakpoints, which they are for every interval
+   * the occupancy was built from.
+   * @return
+   */
+  [[nodiscard]] std::pair<std::size_t, std::size_t> GetSegments(const Offsets &offsets) const;
+
+ private:
+  std::vector<std::int64_t> breakpoints_;
+  std::vector<unsigned int> occupancy_;
+  std::int64_t empty_length_ = 0;
+
+  void Build(std::int64_t length, const std::vector<Offsets> &intervals);
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_OCCUPANCY_H_
@@ -0,0 +1,97 @@
+/**
+ * @file PresenceCalendar.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_PRESENCECALENDAR_H_
+#define SPLITBILL_INCLUDE_LIB_PRESENCECALENDAR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "Money.h"
+#include "Occupancy.h"
+
+namespace splitbill {
+
+/**
+ * Presence of each period's person on each day of a billing period, stored as bitsets.
+ *
+ * Each day is a column of bits, one per presence period ("row").  A day's occupancy is the popcount of its column, and
+ * a row's cost is the sum of the costs of the days whose column has its bit set, so neither needs any per-period date
+ * checks.  Columns are 64 rows to a word, which keeps dense rosters in a few cache lines per day.
+ */
+class PresenceCalendar {
+ public:
+  explicit PresenceCalendar(const boost::gregorian::date_period &period,
+                            const std::vector<PersonPeriod> &person_periods);
+
+  [[nodiscard]] std::size_t GetDayCount() const { return occupancy_.size(); }
+
+  /**
+   * Number of rows, one per presence period.
+   * @return
+   */
+  [[nodiscard]] std::size_t GetRowCount() const { return row_count_; }
+
+  /**
+   * Number of words in each day's column
+   * @return
+   */
+  [[nodiscard]] std::size_t GetWordCount() const { return word_count_; }
+
+  /**
+   * Number of presence periods covering <day>.
+   * @param day
+   * @return
+   */
+  [[nodiscard]] unsigned int GetOccupancy(std::size_t day) const { return occupancy_.at(day); }
+
+  /**
+   * Number of days no one was present
+   * @return
+   */
+  [[nodiscard]] std::int64_t GetEmptyLength() const { return empty_length_; }
+
+  /**
+   * Is the period in <row> present on the day <day> days after the start of the billing period?
+   * @param row
+   * @param day
+   * @return
+   */
+  [[nodiscard]] bool IsPresent(std::size_t row, std::size_t day) const {
+    return (columns_.at(day * word_count_ + row / 64) >> (row % 64)) & 1u;
+  }
+
+  /**
+   * Add the cost of each day to every row present that day.
+   *
+   * Only rows in words [<first_word>, <last_word>) are touched, so callers can give each thread its own words.
+   *
+   * @param day_costs <cost_count> costs for each day, day by day
+   * @param cost_count
+   * @param first_word
+   * @param last_word
+   * @param row_costs <cost_count> sums for each row, row by row
+   */
+  void AddPresentCosts(const Money *day_costs,
+                       std::size_t cost_count,
+                       std::size_t first_word,
+                       std::size_t last_word,
+                       Money *row_costs) const;
+
+ private:
+  std::size_t row_count_ = 0;
+  std::size_t word_count_ = 0;
+  std::vector<std::uint64_t> columns_;
+  std::vector<unsigned int> occupancy_;
+  std::int64_t empty_length_ = 0;
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_PRESENCECALENDAR_H_
@@ -0,0 +1,72 @@
+/**
+ * @file Roster.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_ROSTER_H_
+#define SPLITBILL_INCLUDE_LIB_ROSTER_H_
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace splitbill {
+
+/**
+ * Dense index of a person in a Roster
+ */
+using PersonId = std::uint32_t;
+
+/**
+ * Marks something that does not refer to a person in a Roster
+ */
+inline constexpr PersonId kNoPersonId = std::numeric_limits<PersonId>::max();
+
+/**
+ * The people a bill is split between.
+ *
+ * Each distinct name is given the next ID when it is added, so IDs can index vectors directly.
+ */
+class Roster {
+ public:
+  explicit Roster() = default;
+
+  /**
+   * Create a roster containing <people>, in order.  Repeated names are only added once.
+   * @param people
+   */
+  explicit Roster(const std::vector<std::string> &people);
+
+  /**
+   * Add a person, if they are not already present.
+   * @param name
+   * @return The person's ID.
+   */
+  PersonId Add(const std::string &name);
+
+  /**
+   * @param name
+   * @return The person's ID, or nothing if they are not in the roster.
+   */
+  [[nodiscard]] std::optional<PersonId> Find(const std::string &name) const;
+
+  [[nodiscard]] const std::string &GetName(PersonId person_id) const { return names_.at(person_id); }
+
+  [[nodiscard]] const std::vector<std::string> &GetNames() const { return names_; }
+
+  [[nodiscard]] std::size_t GetPersonCount() const { return names_.size(); }
+
+ private:
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, PersonId> ids_;
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_ROSTER_H_
@@ -0,0 +1,108 @@
+/**
+ * @file SplitCache.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_SPLITCACHE_H_
+#define SPLITBILL_INCLUDE_LIB_SPLITCACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "Bill.h"
+#include "Roster.h"
+
+namespace splitbill {
+
+/**
+ * Remembers the most recently used splits so repeating one returns the stored portions.
+ *
+ * A split only depends on the bill's usage and general totals, the billing period, the presence periods, the roster,
+ * and the split mode, so those form the key.  Bills with different lines but the same totals share entries.  Keys are
+ * compared in full on a hit, so a hash collision can never return the wrong portions.  Modes round segments
+ * differently and can differ in the last digit, so they never share an entry.  The thread count doesn't change the
+ * result and is not part of the key.
+ *
+ * Not thread-safe.
+ */
+class SplitCache {
+ public:
+  /**
+   * @param capacity Most splits to keep.  The least recently used split is dropped to make room for a new one.
+   */
+  explicit SplitCache(std::size_t capacity);
+
+  /**
+   * The same as <bill>.Split(<period>, <person_periods>, <roster>, <options>), reusing a stored result if there is one.
+   */
+  [[nodiscard]] std::vector<BillPortion> Split(const Bill &bill,
+                                               const boost::gregorian::date_period &period,
+                                               const std::vector<PersonPeriod> &person_periods,
+                                               const Roster &roster,
+                                               const SplitOptions &options = SplitOptions());
+
+  [[nodiscard]] std::size_t GetCapacity() const { return capacity_; }
+
+  /**
+   * Change the capacity, dropping the least recently used splits if there are too many.
+   * @param capacity
+   */
+  void SetCapacity(std::size_t capacity);
+
+  [[nodiscard]] std::size_t GetSize() const { return entries_.size(); }
+
+  /**
+   * Number of splits answered from the cache
+   * @return
+   */
+  [[nodiscard]] std::uint64_t GetHitCount() const { return hit_count_; }
+
+  /**
+   * Number of splits that had to be computed
+   * @return
+   */
+  [[nodiscard]] std::uint64_t GetMissCount() const { return miss_count_; }
+
+  /**
+   * Drop all stored splits and reset the counters.
+   */
+  void Clear();
+
+ private:
+  struct Key {
+    Money usage_total;
+    Money general_total;
+    boost::gregorian::date_period period;
+    std::vector<PersonPeriod> person_periods;
+    std::vector<std::string> people;
+    SplitMode mode;
+
+    bool operator==(const Key &rhs) const;
+    [[nodiscard]] std::size_t GetHash() const;
+  };
+  struct Entry {
+    Key key;
+    std::size_t hash;
+    std::vector<BillPortion> portions;
+  };
+
+  std::size_t capacity_;
+  // Most recently used first
+  std::list<Entry> entries_;
+  std::unordered_multimap<std::size_t, std::list<Entry>::iterator> index_;
+  std::uint64_t hit_count_ = 0;
+  std::uint64_t miss_count_ = 0;
+
+  void Evict();
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_SPLITCACHE_H_
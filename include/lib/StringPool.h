@@ -0,0 +1,84 @@
+/**
+ * @file StringPool.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_STRINGPOOL_H_
+#define SPLITBILL_INCLUDE_LIB_STRINGPOOL_H_
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace splitbill {
+
+/**
+ * Handle to a string in a StringPool
+ */
+using StringId = std::uint32_t;
+
+/**
+ * Stores each distinct string once and hands out small IDs for them.
+ *
+ * Equal strings always get the same ID, so comparing IDs from the same pool is the same as comparing the strings.
+ * Each ID counts the references to it.  A string is dropped when its last reference is released, and its ID is reused
+ * by a later string, so a long run of edits doesn't keep every text the pool has ever held.
+ */
+class StringPool {
+ public:
+  explicit StringPool() = default;
+
+  StringPool(const StringPool &other);
+
+  StringPool(StringPool &&other) noexcept = default;
+
+  StringPool &operator=(const StringPool &other);
+
+  StringPool &operator=(StringPool &&other) noexcept = default;
+
+  /**
+   * Add a reference to <value>, adding it if it is not already present.
+   * @param value
+   * @return The string's ID.
+   */
+  StringId Intern(std::string_view value);
+
+  /**
+   * Drop a reference from Intern().  The string is removed when no references are left.
+   * @param id
+   */
+  void Release(StringId id);
+
+  /**
+   * @param value
+   * @return The string's ID, or nothing if it isn't in the pool.
+   */
+  [[nodiscard]] std::optional<StringId> Find(std::string_view value) const;
+
+  [[nodiscard]] const std::string &Get(StringId id) const { return strings_.at(id); }
+
+  /**
+   * Number of strings with references
+   * @return
+   */
+  [[nodiscard]] std::size_t GetSize() const { return ids_.size(); }
+
+ private:
+  // A deque never moves its elements, so the index can refer to them.
+  std::deque<std::string> strings_;
+  std::vector<std::size_t> references_;
+  // IDs of removed strings, ready for reuse
+  std::vector<StringId> free_ids_;
+  std::unordered_map<std::string_view, StringId> ids_;
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_STRINGPOOL_H_
@@ -0,0 +1,71 @@
+/**
+ * @file TaxRate.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_INCLUDE_LIB_TAXRATE_H_
+#define SPLITBILL_INCLUDE_LIB_TAXRATE_H_
+
+#include <cmath>
+#include <cstdint>
+#include "Money.h"
+
+namespace splitbill {
+
+/**
+ * Tax rate stored as an exact count of millionths (hundredths of a basis point).
+ *
+ * This is fine enough for any rate entered as a percentage with up to four decimals.  Rates compare exactly, so lines
+ * can be grouped by rate and tax applied once per group.
+ */
+class TaxRate {
+ public:
+  static constexpr std::int64_t kScale = 1'000'000;
+
+  constexpr TaxRate() = default;
+
+  /**
+   * @param rate Fraction of the amount, e.g. 0.07 for 7%.  Rounded to the nearest millionth.
+   */
+  TaxRate(double rate) :
+      millionths_(std::llround(rate * kScale)) {}
+
+  [[nodiscard]] static constexpr TaxRate FromMillionths(std::int64_t millionths) {
+    TaxRate rate;
+    rate.millionths_ = millionths;
+    return rate;
+  }
+
+  [[nodiscard]] constexpr std::int64_t GetMillionths() const { return millionths_; }
+
+  [[nodiscard]] double ToDouble() const {
+    return static_cast<double>(millionths_) / kScale;
+  }
+
+  /**
+   * <amount> with this rate of tax added
+   * @param amount
+   * @return
+   */
+  [[nodiscard]] Money Apply(const Money &amount) const {
+    if (millionths_ == 0) {
+      return amount;
+    }
+    // Scale by (1,000,000 + millionths) / 1,000,000 so the rate never passes through a double.
+    return amount.Scale(kScale + millionths_, kScale);
+  }
+
+  constexpr bool operator==(const TaxRate &rhs) const { return millionths_ == rhs.millionths_; }
+  constexpr bool operator!=(const TaxRate &rhs) const { return millionths_ != rhs.millionths_; }
+  constexpr bool operator<(const TaxRate &rhs) const { return millionths_ < rhs.millionths_; }
+
+ private:
+  std::int64_t millionths_ = 0;
+};
+
+} // splitbill
+
+#endif //SPLITBILL_INCLUDE_LIB_TAXRATE_H_
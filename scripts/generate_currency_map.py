@@ -37,6 +37,15 @@ def read_currency_info(data: ET.ElementTree) -> Dict[str, CurrencyInfo]:
     return currency_info
 
 
+def pack_code(code: str) -> int:
+    """
+    Pack a 3-letter currency code into an integer, matching Currency::PackCode().
+    :param code:
+    :return:
+    """
+    return (ord(code[0]) << 16) | (ord(code[1]) << 8) | ord(code[2])
+
+
 def generate(currency_info: Dict[str, CurrencyInfo]) -> str:
     """
     Generate the Currency.h file.
@@ -53,54 +62,83 @@ def generate(currency_info: Dict[str, CurrencyInfo]) -> str:
 #ifndef SPLITBILL_INCLUDE_LIB_CURRENCY_H
 #define SPLITBILL_INCLUDE_LIB_CURRENCY_H
 
-#include <cmath>
-#include <string>
-#include <unordered_map>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
 
 namespace splitbill {
 
 class Currency {
  public:
+  enum class Code : std::uint16_t {
+    $currency_codes
+  };
+
   struct Info {
-    std::string iso_4217_code;
+    Code code;
+    std::string_view iso_4217_code;
     unsigned int minor_units;
-    
-    [[nodiscard]] unsigned int multiplier() const {
-      return std::pow(10, minor_units);
+    unsigned int minor_unit_multiplier;
+    double minor_unit_error_margin;
+
+    [[nodiscard]] constexpr unsigned int multiplier() const {
+      return minor_unit_multiplier;
     }
-    
-    [[nodiscard]] double error_margin() const {
-      return 1.0 / std::pow(10, minor_units + 1);
+
+    [[nodiscard]] constexpr double error_margin() const {
+      return minor_unit_error_margin;
     }
 
-    [[nodiscard]] bool operator==(const Info &rhs) const {
-      return iso_4217_code == rhs.iso_4217_code;
+    [[nodiscard]] constexpr bool operator==(const Info &rhs) const {
+      return code == rhs.code;
     }
 
-    [[nodiscard]] bool operator!=(const Info &rhs) const {
+    [[nodiscard]] constexpr bool operator!=(const Info &rhs) const {
       return !(rhs == *this);
     }
   };
 
-  enum class Code {
-    $currency_codes
-  };
-
-  static inline const Info &Get(Code code) {
-    return kCurrencyInfo.at(code);
+  [[nodiscard]] static constexpr const Info &Get(Code code) {
+    return kCurrencyInfo[static_cast<std::size_t>(code)];
   }
 
-  static inline const Info &Get(const std::string &code) {
-    return Get(kCodeMap.at(code));
+  [[nodiscard]] static constexpr const Info &Get(std::string_view code) {
+    // The table is sorted by code, so the packed codes can be binary searched.
+    const std::uint32_t key = PackCode(code);
+    std::size_t first = 0;
+    std::size_t last = kCodeKeys.size();
+    while (first < last) {
+      const std::size_t mid = first + (last - first) / 2;
+      if (kCodeKeys[mid] < key) {
+        first = mid + 1;
+      } else {
+        last = mid;
+      }
+    }
+    if (first == kCodeKeys.size() || kCodeKeys[first] != key) {
+      throw std::out_of_range("Unknown currency code");
+    }
+    return kCurrencyInfo[first];
   }
 
  private:
-  static inline const std::unordered_map<Code, Info> kCurrencyInfo{
+  [[nodiscard]] static constexpr std::uint32_t PackCode(std::string_view code) {
+    if (code.size() != 3) {
+      return 0;
+    }
+    return (static_cast<std::uint32_t>(static_cast<unsigned char>(code[0])) << 16)
+        | (static_cast<std::uint32_t>(static_cast<unsigned char>(code[1])) << 8)
+        | static_cast<std::uint32_t>(static_cast<unsigned char>(code[2]));
+  }
+
+  static constexpr std::array<Info, $currency_count> kCurrencyInfo{{
       $currency_info
-  };
-  static inline const std::unordered_map<std::string, Code> kCodeMap{
-      $code_map_codes
-  };
+  }};
+  static constexpr std::array<std::uint32_t, $currency_count> kCodeKeys{{
+      $code_keys
+  }};
 };
 
 } // splitbill
@@ -108,25 +146,31 @@ class Currency {
 #endif //SPLITBILL_INCLUDE_LIB_CURRENCY_H
 
     '''.strip() + os.linesep)
-    currency_code_enums = (',' + os.linesep + (' ' * 4)).join(currency_info.keys())
+    # Codes are sorted so the enum value is the table index and Get(std::string_view) can binary search.
+    currencies = sorted(currency_info.values(), key=lambda currency: currency.iso_4217_code)
+    currency_code_enums = (',' + os.linesep + (' ' * 4)).join(currency.iso_4217_code for currency in currencies)
     currency_info_members = (',' + os.linesep + (' ' * 6)).join(
         [
-            '{{Code::{code}, {{"{code}", {minor_units}}}}}'.format(
-                code=currency.iso_4217_code, minor_units=currency.minor_units)
-            for currency in currency_info.values()
+            '{{Code::{code}, "{code}", {minor_units}, {multiplier}, {error_margin!r}}}'.format(
+                code=currency.iso_4217_code,
+                minor_units=currency.minor_units,
+                multiplier=10 ** currency.minor_units,
+                error_margin=1 / 10 ** (currency.minor_units + 1))
+            for currency in currencies
         ]
     )
-    code_map_members = (',' + os.linesep + (' ' * 6)).join(
+    code_key_members = (',' + os.linesep + (' ' * 6)).join(
         [
-            '{{"{code}", Code::{code}}}'.format(code=currency_code)
-            for currency_code in currency_info.keys()
+            '0x{key:06X}u /* {code} */'.format(key=pack_code(currency.iso_4217_code), code=currency.iso_4217_code)
+            for currency in currencies
         ]
     )
 
     return template.substitute({
         'currency_codes': currency_code_enums,
+        'currency_count': len(currencies),
         'currency_info': currency_info_members,
-        'code_map_codes': code_map_members,
+        'code_keys': code_key_members,
     })
 
 
@@ -5,118 +5,416 @@
  * @date 6/3/20
  */
 
-#include <numeric>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
 #include "Bill.h"
+#include "LineKernels.h"
+#include "Occupancy.h"
+#include "Parallel.h"
+#include "PresenceCalendar.h"
 
 namespace splitbill {
 
-SplitBill Bill::Total() {
-  if (lines_.empty()) {
-    // Empty bill
-    return SplitBill(Money(0, GetCurrency()), Money(0, GetCurrency()));
-  }
-
-  // Get the lines that refer to usage and those that don't.
-  std::vector<BillLine> usage_lines;
-  std::vector<BillLine> general_lines;
-  SortLinesBySplit(lines_, usage_lines, general_lines);
-
-  // Sanity check to ensure there's something to work with for the rest of the process.
-  // These lines have amount and tax rate 0 so they won't affect calculations
-  if (usage_lines.empty()) {
-    BillLine dummy_usage(GetCurrency());
-    dummy_usage.split = true;
-    usage_lines.push_back(dummy_usage);
-  }
-  if (general_lines.empty()) {
-    BillLine dummy_general(GetCurrency());
-    dummy_general.split = false;
-    general_lines.push_back(dummy_general);
-  }
-
-  // Apply tax
-  const std::vector<BillLine> all_lines = ApplyTax(lines_);
-  usage_lines = ApplyTax(usage_lines);
-  general_lines = ApplyTax(general_lines);
-
-  // Tote the lines
-  const std::vector<Money> all_amounts = GetAmounts(all_lines);
-  const std::vector<Money> usage_amounts = GetAmounts(usage_lines);
-  const std::vector<Money> general_amounts = GetAmounts(general_lines);
-  const Money all_total =
-      std::accumulate(all_amounts.cbegin(), all_amounts.cend(), Money(0, GetCurrency()));
-  const Money usage_total =
-      std::accumulate(usage_amounts.cbegin(), usage_amounts.cend(), Money(0, GetCurrency()));
-  const Money general_total =
-      std::accumulate(general_amounts.cbegin(), general_amounts.cend(), Money(0, GetCurrency()));
+SplitBill Bill::Total() const {
+  return SplitBill(usage_total_, general_total_);
+}
 
+SplitBill Bill::TotalLines() const {
+  const Currency::Code currency = lines_.GetCurrencyCode();
+  Money usage_total(0, currency);
+  Money general_total(0, currency);
+#ifdef SPLITBILL_MONEY_DECIMAL
+  for (const auto &bucket : tax_buckets_) {
+    Money untaxed_usage(0, currency);
+    Money untaxed_general(0, currency);
+    for (size_t pos = 0; pos < lines_.GetCount(); pos++) {
+      if (lines_.GetTaxRate(pos) != bucket.tax_rate) {
+        continue;
+      }
+      if (lines_.IsSplit(pos)) {
+        untaxed_usage = untaxed_usage + lines_.GetAmount(pos);
+      } else {
+        untaxed_general = untaxed_general + lines_.GetAmount(pos);
+      }
+    }
+    usage_total = usage_total + bucket.tax_rate.Apply(untaxed_usage);
+    general_total = general_total + bucket.tax_rate.Apply(untaxed_general);
+  }
+#else
+  // Every rate in use already has a bucket.
+  std::vector<TaxRate> rates;
+  rates.reserve(tax_buckets_.size());
+  for (const auto &bucket : tax_buckets_) {
+    rates.push_back(bucket.tax_rate);
+  }
+  std::vector<LineSums> sums(rates.size());
+  SumLinesByTaxRate(lines_.GetAmounts().data(), lines_.GetTaxRates().data(), lines_.GetSplitBits().data(),
+                    lines_.GetCount(), rates.data(), sums.data(), rates.size());
+  for (size_t rate = 0; rate < rates.size(); rate++) {
+    const Money untaxed_usage = Money::FromDecimal(FixedDecimal::FromRaw(sums[rate].usage), currency);
+    const Money untaxed_general = Money::FromDecimal(FixedDecimal::FromRaw(sums[rate].general), currency);
+    usage_total = usage_total + rates[rate].Apply(untaxed_usage);
+    general_total = general_total + rates[rate].Apply(untaxed_general);
+  }
+#endif
   return SplitBill(usage_total, general_total);
 }
 
-#define FOR_DAY_IN_PERIOD(day_var, period) for (boost::gregorian::date day_var = period.begin(); day_var <= period.last(); day_var += boost::gregorian::date_duration(1))
-
-std::vector<splitbill::BillPortion> Bill::Split(const boost::gregorian::date_period &period,
-                                                const std::vector<PersonPeriod> &person_periods,
-                                                const std::vector<std::string> &people) {
-  if (people.empty()) {
-    return std::vector<splitbill::BillPortion>();
-  }
+namespace {
 
-  SplitBill totals = Total();
-  const Money usage_part = totals.GetUsageTotal() / period.length().days();
-
-  // First pass: Determine how many parts each day must be split into.
-  std::map<boost::gregorian::date, unsigned int> day_parts;
-  unsigned int everyone_usage_days = 0;
-  FOR_DAY_IN_PERIOD(day, period) {
-    unsigned int day_part_count = 0;
-    for (const auto &person_period : person_periods) {
-      if (person_period.GetPeriod().contains(day)) {
-        day_part_count++;
+/**
+ * The roster ID of each period's person, or kNoPersonId if they are not in the roster.
+ */
+template<class Period>
+std::vector<PersonId> GetPersonIds(const std::vector<Period> &person_periods, const Roster &roster) {
+  std::vector<PersonId> person_ids;
+  person_ids.reserve(person_periods.size());
+  for (const auto &person_period : person_periods) {
+    if (person_period.GetPersonId() != kNoPersonId) {
+      if (person_period.GetPersonId() >= roster.GetPersonCount()) {
+        throw std::out_of_range("Person period refers to a person not in the roster");
       }
+      person_ids.push_back(person_period.GetPersonId());
+    } else {
+      person_ids.push_back(roster.Find(person_period.GetName()).value_or(kNoPersonId));
     }
-    if (day_part_count == 0) {
-      // No people were set for this period, so assume everyone
-      day_part_count = people.size();
-      everyone_usage_days++;
+  }
+
+  return person_ids;
+}
+
+/**
+ * A zero of each bill's currency.
+ */
+std::vector<Money> MakeZeros(const std::vector<Money> &usage_totals) {
+  std::vector<Money> zeros;
+  zeros.reserve(usage_totals.size());
+  for (const auto &usage_total : usage_totals) {
+    zeros.emplace_back(0, usage_total.GetCurrencyCode());
+  }
+  return zeros;
+}
+
+/**
+ * Presence in a given unit costs that unit's usage divided among the people present.  Only divide once for each
+ * number of people present.
+ *
+ * @return A matrix with a row for each number of people present from 0 to <max_parts> and a column per bill
+ */
+std::vector<Money> MakePartCosts(const std::vector<Money> &usage_totals,
+                                 std::int64_t unit_count,
+                                 const std::vector<Money> &zeros,
+                                 unsigned int max_parts) {
+  std::vector<Money> part_costs(zeros);
+  part_costs.reserve((max_parts + 1) * usage_totals.size());
+  for (unsigned int parts = 1; parts <= max_parts; parts++) {
+    for (const auto &usage_total : usage_totals) {
+      part_costs.push_back(usage_total.Scale(1, unit_count * parts));
     }
-    day_parts.insert({day, day_part_count});
   }
-  // Handle days where no person was present
-  const Money everyone_usage = (usage_part / people.size()) * everyone_usage_days;
+  return part_costs;
+}
+
+/**
+ * Start each person's usage with their share of the units where no person was present, which are split among everyone.
+ *
+ * @return A matrix with a row per person and a column per bill
+ */
+std::vector<Money> MakeEveryoneUsages(const std::vector<Money> &usage_totals,
+                                      std::int64_t unit_count,
+                                      std::size_t person_count,
+                                      std::int64_t empty_length) {
+  std::vector<Money> everyone_usages;
+  everyone_usages.reserve(usage_totals.size());
+  for (const auto &usage_total : usage_totals) {
+    everyone_usages.push_back(usage_total.Scale(empty_length, unit_count * static_cast<std::int64_t>(person_count)));
+  }
+  std::vector<Money> person_usages;
+  person_usages.reserve(person_count * usage_totals.size());
+  for (std::size_t person_id = 0; person_id < person_count; person_id++) {
+    person_usages.insert(person_usages.end(), everyone_usages.cbegin(), everyone_usages.cend());
+  }
+  return person_usages;
+}
 
-  // Second pass: divide the amount into chunks for each day, then divide those chunks into parts for
-  // each user present on that day.  The end result of this is that presence on a given day costs a
-  // certain amount.
-  std::map<boost::gregorian::date, Money> day_usage_amounts;
-  FOR_DAY_IN_PERIOD(day, period) {
-    day_usage_amounts.insert({day, usage_part / day_parts.at(day)});
+/**
+ * Total each person's usage of several bills.
+ *
+ * Costs form a matrix with a row per segment and a column per bill, so each presence period adds the difference of two
+ * rows of running sums to its person's row.  Each segment's cost is the usage total times the segment's share of the
+ * billing period, divided once, so fine units don't compound the rounding of a tiny per-unit cost.  Each person's
+ * periods are added in their original order whichever thread handles them, so results are the same for any thread
+ * count and for any other bills in the batch.
+ *
+ * @tparam Occupancy DayOccupancy or IntervalOccupancy
+ * @param occupancy
+ * @param usage_totals Usage total of each bill
+ * @param unit_count Number of time units in the billing period
+ * @param offsets The time units each presence period covers
+ * @param person_ids The person ID of each presence period
+ * @param person_count
+ * @param threads
+ * @return Each person's usage of each bill, as a matrix with a row per person and a column per bill
+ */
+template<class Occupancy>
+std::vector<Money> SplitUsage(const Occupancy &occupancy,
+                              const std::vector<Money> &usage_totals,
+                              std::int64_t unit_count,
+                              const std::vector<Offsets> &offsets,
+                              const std::vector<PersonId> &person_ids,
+                              std::size_t person_count,
+                              unsigned int threads) {
+  const std::size_t bill_count = usage_totals.size();
+  const std::size_t segment_count = occupancy.GetSegmentCount();
+  const std::vector<Money> zeros = MakeZeros(usage_totals);
+  unsigned int max_parts = 0;
+  for (std::size_t segment = 0; segment < segment_count; segment++) {
+    max_parts = std::max(max_parts, occupancy.GetOccupancy(segment));
   }
+  const std::vector<Money> part_costs = MakePartCosts(usage_totals, unit_count, zeros, max_parts);
 
-  // Third pass: total each user's contribution.
-  const Money general_chunk = totals.GetGeneralTotal() / people.size();
-  std::vector<splitbill::BillPortion> portions;
-  portions.reserve(people.size());
-  for (const auto &person : people) {
-    Money person_usage = everyone_usage;
-    for (const auto &person_period : person_periods) {
-      if (person_period.GetName() != person) {
+  // Segments are independent, so their costs are spread across threads.
+  std::vector<Money> segment_costs;
+  segment_costs.reserve(segment_count * bill_count);
+  for (std::size_t segment = 0; segment < segment_count; segment++) {
+    segment_costs.insert(segment_costs.end(), zeros.cbegin(), zeros.cend());
+  }
+  ParallelFor(segment_count, threads, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t segment = begin; segment < end; segment++) {
+      const unsigned int parts = occupancy.GetOccupancy(segment);
+      const std::int64_t length = occupancy.GetSegmentLength(segment);
+      if (parts == 0) {
         continue;
       }
-      FOR_DAY_IN_PERIOD(day, period) {
-        if (!person_period.GetPeriod().contains(day)) {
-          continue;
+      for (std::size_t bill = 0; bill < bill_count; bill++) {
+        segment_costs[segment * bill_count + bill] = length == 1 ? part_costs[parts * bill_count + bill]
+                                                                 : usage_totals[bill].Scale(length, unit_count * parts);
+      }
+    }
+  });
+
+  // Keep running sums of the costs so a person's cost for any run of segments is a single subtraction.
+  std::vector<Money> segment_cost_sums(zeros);
+  segment_cost_sums.reserve((segment_count + 1) * bill_count);
+  for (std::size_t i = 0; i < segment_costs.size(); i++) {
+    segment_cost_sums.push_back(segment_cost_sums[i] + segment_costs[i]);
+  }
+
+  std::vector<Money> person_usages =
+      MakeEveryoneUsages(usage_totals, unit_count, person_count, occupancy.GetEmptyLength());
+
+  // Group periods by person so each thread owns a range of people.
+  std::vector<std::size_t> person_period_starts(person_count + 1, 0);
+  for (const PersonId person_id : person_ids) {
+    if (person_id != kNoPersonId) {
+      person_period_starts[person_id + 1]++;
+    }
+  }
+  for (std::size_t person_id = 0; person_id < person_count; person_id++) {
+    person_period_starts[person_id + 1] += person_period_starts[person_id];
+  }
+  std::vector<std::size_t> grouped_periods(person_period_starts.back());
+  std::vector<std::size_t> next_slot(person_period_starts.cbegin(), person_period_starts.cend() - 1);
+  for (std::size_t i = 0; i < person_ids.size(); i++) {
+    if (person_ids[i] != kNoPersonId) {
+      grouped_periods[next_slot[person_ids[i]]++] = i;
+    }
+  }
+  ParallelFor(person_count, threads, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t person_id = begin; person_id < end; person_id++) {
+      Money *person_usage = &person_usages[person_id * bill_count];
+      for (std::size_t i = person_period_starts[person_id]; i < person_period_starts[person_id + 1]; i++) {
+        const auto [first, last] = occupancy.GetSegments(offsets[grouped_periods[i]]);
+        const Money *first_sums = &segment_cost_sums[first * bill_count];
+        const Money *last_sums = &segment_cost_sums[last * bill_count];
+        for (std::size_t bill = 0; bill < bill_count; bill++) {
+          person_usage[bill] = person_usage[bill] + (last_sums[bill] - first_sums[bill]);
         }
-        person_usage = person_usage + day_usage_amounts.at(day);
       }
     }
-    portions.emplace_back(person, person_usage, general_chunk);
+  });
+
+  return person_usages;
+}
+
+/**
+ * Total each person's usage of several bills from a presence calendar.
+ *
+ * Each day's cost comes from the popcount of its column, then each row sums the costs of the days its bit is set.
+ * Threads own ranges of 64-row words, and rows are added to their people in their original order, so results are the
+ * same for any thread count.
+ *
+ * @param calendar
+ * @param usage_totals Usage total of each bill
+ * @param person_ids The person ID of each row
+ * @param person_count
+ * @param threads
+ * @return Each person's usage of each bill, as a matrix with a row per person and a column per bill
+ */
+std::vector<Money> SplitCalendarUsage(const PresenceCalendar &calendar,
+                                      const std::vector<Money> &usage_totals,
+                                      const std::vector<PersonId> &person_ids,
+                                      std::size_t person_count,
+                                      unsigned int threads) {
+  const std::size_t bill_count = usage_totals.size();
+  const std::size_t day_count = calendar.GetDayCount();
+  const std::vector<Money> zeros = MakeZeros(usage_totals);
+  unsigned int max_parts = 0;
+  for (std::size_t day = 0; day < day_count; day++) {
+    max_parts = std::max(max_parts, calendar.GetOccupancy(day));
+  }
+  const auto unit_count = static_cast<std::int64_t>(day_count);
+  const std::vector<Money> part_costs = MakePartCosts(usage_totals, unit_count, zeros, max_parts);
+
+  std::vector<Money> day_costs;
+  day_costs.reserve(day_count * bill_count);
+  for (std::size_t day = 0; day < day_count; day++) {
+    const auto first = part_costs.cbegin() + calendar.GetOccupancy(day) * bill_count;
+    day_costs.insert(day_costs.end(), first, first + bill_count);
   }
 
-  return portions;
+  const std::size_t row_count = calendar.GetRowCount();
+  std::vector<Money> row_costs;
+  row_costs.reserve(row_count * bill_count);
+  for (std::size_t row = 0; row < row_count; row++) {
+    row_costs.insert(row_costs.end(), zeros.cbegin(), zeros.cend());
+  }
+  ParallelFor(calendar.GetWordCount(), threads, [&](std::size_t begin, std::size_t end) {
+    calendar.AddPresentCosts(day_costs.data(), bill_count, begin, end, row_costs.data());
+  });
+
+  std::vector<Money> person_usages =
+      MakeEveryoneUsages(usage_totals, unit_count, person_count, calendar.GetEmptyLength());
+  for (std::size_t row = 0; row < row_count; row++) {
+    if (person_ids[row] == kNoPersonId) {
+      continue;
+    }
+    Money *person_usage = &person_usages[person_ids[row] * bill_count];
+    const Money *row_cost = &row_costs[row * bill_count];
+    for (std::size_t bill = 0; bill < bill_count; bill++) {
+      person_usage[bill] = person_usage[bill] + row_cost[bill];
+    }
+  }
+
+  return person_usages;
 }
 
-bool Bill::IsValid(ValidationError &error) {
+/**
+ * Turn each person's usage of each bill into portions.
+ */
+std::vector<std::vector<BillPortion>> MakePortions(const std::vector<const Bill *> &bills,
+                                                   const std::vector<Money> &person_usages,
+                                                   const Roster &roster) {
+  const std::size_t person_count = roster.GetPersonCount();
+  std::vector<std::vector<BillPortion>> bill_portions(bills.size());
+  for (std::size_t bill = 0; bill < bills.size(); bill++) {
+    const Money general_chunk = bills[bill]->Total().GetGeneralTotal() / person_count;
+    std::vector<BillPortion> &portions = bill_portions[bill];
+    portions.reserve(person_count);
+    for (PersonId person_id = 0; person_id < person_count; person_id++) {
+      portions.emplace_back(person_id,
+                            roster.GetName(person_id),
+                            person_usages[person_id * bills.size() + bill],
+                            general_chunk);
+    }
+  }
+
+  return bill_portions;
+}
+
+/**
+ * Split several bills over the same period among the same people.
+ */
+std::vector<std::vector<BillPortion>> SplitBills(const std::vector<const Bill *> &bills,
+                                                 const boost::gregorian::date_period &period,
+                                                 const std::vector<PersonPeriod> &person_periods,
+                                                 const Roster &roster,
+                                                 const SplitOptions &options) {
+  const std::size_t person_count = roster.GetPersonCount();
+  if (person_count == 0 || bills.empty()) {
+    return std::vector<std::vector<BillPortion>>(bills.size());
+  }
+
+  std::vector<Money> usage_totals;
+  usage_totals.reserve(bills.size());
+  for (const Bill *bill : bills) {
+    usage_totals.push_back(bill->Total().GetUsageTotal());
+  }
+  const std::int64_t day_count = period.length().days();
+
+  std::vector<Offsets> offsets;
+  offsets.reserve(person_periods.size());
+  for (const auto &person_period : person_periods) {
+    offsets.push_back(GetDayOffsets(period, person_period.GetPeriod()));
+  }
+  const std::vector<PersonId> person_ids = GetPersonIds(person_periods, roster);
+  const unsigned int threads = GetThreadCount(options.threads);
+  std::vector<Money> person_usages;
+  if (options.mode == SplitMode::kDaily) {
+    person_usages = SplitUsage(DayOccupancy(period, person_periods), usage_totals, day_count, offsets, person_ids,
+                               person_count, threads);
+  } else if (options.mode == SplitMode::kPresenceCalendar) {
+    person_usages = SplitCalendarUsage(PresenceCalendar(period, person_periods), usage_totals, person_ids,
+                                       person_count, threads);
+  } else {
+    person_usages = SplitUsage(IntervalOccupancy(period, person_periods), usage_totals, day_count, offsets,
+                               person_ids, person_count, threads);
+  }
+
+  return MakePortions(bills, person_usages, roster);
+}
+
+} // namespace
+
+std::vector<splitbill::BillPortion> Bill::Split(const boost::gregorian::date_period &period,
+                                                const std::vector<PersonPeriod> &person_periods,
+                                                const Roster &roster,
+                                                const SplitOptions &options) const {
+  return std::move(SplitBills({this}, period, person_periods, roster, options).front());
+}
+
+std::vector<splitbill::BillPortion> Bill::Split(const boost::posix_time::time_period &period,
+                                                const std::vector<PersonTimePeriod> &person_periods,
+                                                const Roster &roster,
+                                                const boost::posix_time::time_duration &resolution,
+                                                const SplitOptions &options) const {
+  if (resolution.ticks() <= 0) {
+    throw std::invalid_argument("Split resolution must be positive");
+  }
+  const std::size_t person_count = roster.GetPersonCount();
+  if (person_count == 0) {
+    return {};
+  }
+
+  // Occupancy only changes at period starts and ends, so the cost doesn't depend on how fine the resolution is.
+  const std::int64_t length = GetTimeOffsets(period, period, resolution).second;
+  std::vector<Offsets> offsets;
+  offsets.reserve(person_periods.size());
+  for (const auto &person_period : person_periods) {
+    offsets.push_back(GetTimeOffsets(period, person_period.GetPeriod(), resolution));
+  }
+  const std::vector<Money> person_usages = SplitUsage(IntervalOccupancy(length, offsets), {Total().GetUsageTotal()},
+                                                      length, offsets, GetPersonIds(person_periods, roster),
+                                                      person_count, GetThreadCount(options.threads));
+
+  return std::move(MakePortions({this}, person_usages, roster).front());
+}
+
+std::vector<std::vector<BillPortion>> Bill::SplitAll(const std::vector<Bill> &bills,
+                                                     const boost::gregorian::date_period &period,
+                                                     const std::vector<PersonPeriod> &person_periods,
+                                                     const Roster &roster,
+                                                     const SplitOptions &options) {
+  std::vector<const Bill *> bill_pointers;
+  bill_pointers.reserve(bills.size());
+  for (const auto &bill : bills) {
+    bill_pointers.push_back(&bill);
+  }
+  return SplitBills(bill_pointers, period, person_periods, roster, options);
+}
+
+bool Bill::IsValid(ValidationError &error) const {
   // Check line total equals bill total, with tax applied
   SplitBill totals = Total();
   if (std::abs((totals.GetTotal() - GetTotalAmount()).GetValue()) >= GetCurrency().error_margin()) {
@@ -128,41 +426,294 @@ bool Bill::IsValid(ValidationError &error) {
   return true;
 }
 
-std::vector<Money> Bill::GetAmounts(const std::vector<BillLine> &lines) {
-  std::vector<Money> amounts;
-  amounts.reserve(lines.size());
-  for (const auto &line : lines) {
-    amounts.push_back(line.amount);
+std::vector<BillLine> Bill::GetLines() const {
+  std::vector<BillLine> lines;
+  lines.reserve(lines_.GetCount());
+  for (size_t pos = 0; pos < lines_.GetCount(); pos++) {
+    lines.push_back(lines_.Get(pos));
   }
+  return lines;
+}
 
-  return amounts;
+void Bill::AddLine(const BillLine &line, const size_t &pos) {
+  if (pos > lines_.GetCount()) {
+    throw std::out_of_range("Line position is past the end of the bill");
+  }
+  // Update the totals first; they throw if the line is in a different currency.
+  AddToTotals(line.amount, line.tax_rate, line.split);
+  lines_.Insert(pos, line);
+  std::vector<std::size_t> &hashes = line_hash_tree_.front();
+  hashes.insert(hashes.cbegin() + pos, line.GetHash());
+  RehashLineTree(pos, hashes.size());
+  version_++;
 }
 
-std::vector<BillLine> Bill::ApplyTax(const std::vector<BillLine> &lines) {
-  std::vector<BillLine> taxed_lines;
-  taxed_lines.reserve(lines.size());
+void Bill::AddLine(const BillLine &line) {
+  AddLine(line, lines_.GetCount());
+}
+
+void Bill::InsertLines(const std::vector<BillLine> &lines, const size_t &pos) {
+  if (pos > lines_.GetCount()) {
+    throw std::out_of_range("Line position is past the end of the bill");
+  }
+  // Check every line before changing anything, so a bad line leaves the bill as it was.
   for (const auto &line : lines) {
-    BillLine taxed_line(line);
-    taxed_line.amount = line.amount * (line.tax_rate + 1);
-    taxed_lines.push_back(taxed_line);
+    if (line.amount.GetCurrencyCode() != lines_.GetCurrencyCode()) {
+      throw std::invalid_argument("Can only operate on money with the same currency");
+    }
   }
+  if (lines.empty()) {
+    return;
+  }
+  // Retax each bucket once for the whole insert, not once per line.
+  Batch batch(*this);
+  for (const auto &line : lines) {
+    AddToTotals(line.amount, line.tax_rate, line.split);
+  }
+  lines_.Insert(pos, lines);
+  std::vector<std::size_t> line_hashes;
+  line_hashes.reserve(lines.size());
+  for (const auto &line : lines) {
+    line_hashes.push_back(line.GetHash());
+  }
+  std::vector<std::size_t> &hashes = line_hash_tree_.front();
+  hashes.insert(hashes.cbegin() + pos, line_hashes.cbegin(), line_hashes.cend());
+  RehashLineTree(pos, hashes.size());
+  version_++;
+}
 
-  return taxed_lines;
+void Bill::RemoveLine(const size_t &pos) {
+  RemoveFromTotals(lines_.GetAmount(pos), lines_.GetTaxRate(pos), lines_.IsSplit(pos));
+  lines_.Erase(pos);
+  std::vector<std::size_t> &hashes = line_hash_tree_.front();
+  hashes.erase(hashes.cbegin() + pos);
+  // The line that was last has moved, even if it was the one removed.
+  RehashLineTree(hashes.empty() ? 0 : std::min(pos, hashes.size() - 1), hashes.size());
+  version_++;
 }
 
-void Bill::SortLinesBySplit(const std::vector<BillLine> &lines,
-                            std::vector<BillLine> &split_lines,
-                            std::vector<BillLine> &not_split_lines) {
-  split_lines.clear();
-  not_split_lines.clear();
+void Bill::RemoveLines(const std::vector<size_t> &positions) {
+  if (positions.empty()) {
+    return;
+  }
+  if (!std::is_sorted(positions.cbegin(), positions.cend(), std::less_equal<>())) {
+    throw std::invalid_argument("Line positions must be sorted without repeats");
+  }
+  if (positions.back() >= lines_.GetCount()) {
+    throw std::out_of_range("Line position is past the end of the bill");
+  }
+  Batch batch(*this);
+  for (const auto pos : positions) {
+    RemoveFromTotals(lines_.GetAmount(pos), lines_.GetTaxRate(pos), lines_.IsSplit(pos));
+  }
+  lines_.Erase(positions);
 
-  for (const auto &line : lines) {
-    if (line.split) {
-      split_lines.push_back(line);
-    } else {
-      not_split_lines.push_back(line);
+  std::vector<std::size_t> &hashes = line_hash_tree_.front();
+  size_t kept = positions.front();
+  size_t next_removed = 0;
+  for (size_t pos = positions.front(); pos < hashes.size(); pos++) {
+    if (next_removed < positions.size() && positions[next_removed] == pos) {
+      next_removed++;
+      continue;
+    }
+    hashes[kept++] = hashes[pos];
+  }
+  hashes.resize(kept);
+  RehashLineTree(hashes.empty() ? 0 : std::min(positions.front(), hashes.size() - 1), hashes.size());
+  version_++;
+}
+
+void Bill::RemoveLine(const BillLine &line) {
+  // Only lines with the same hash need to be compared.
+  const std::vector<std::size_t> &hashes = line_hash_tree_.front();
+  const std::size_t line_hash = line.GetHash();
+  std::vector<size_t> removed;
+  for (size_t pos = 0; pos < hashes.size(); pos++) {
+    if (hashes[pos] == line_hash && lines_.Equals(pos, line)) {
+      removed.push_back(pos);
+    }
+  }
+  // Nothing matched, so the bill is unchanged and its version stays the same.
+  if (removed.empty()) {
+    return;
+  }
+  RemoveLines(removed);
+}
+
+void Bill::UpdateLine(const size_t &pos, const BillLine &line) {
+  // Check everything before touching the totals, so a bad update leaves the bill as it was.
+  if (pos >= lines_.GetCount()) {
+    throw std::out_of_range("Line position is past the end of the bill");
+  }
+  if (line.amount.GetCurrencyCode() != lines_.GetCurrencyCode()) {
+    throw std::invalid_argument("Can only operate on money with the same currency");
+  }
+  AddToTotals(line.amount, line.tax_rate, line.split);
+  RemoveFromTotals(lines_.GetAmount(pos), lines_.GetTaxRate(pos), lines_.IsSplit(pos));
+  lines_.Set(pos, line);
+  line_hash_tree_.front()[pos] = line.GetHash();
+  RehashLineTree(pos, pos + 1);
+  version_++;
+}
+
+std::size_t Bill::GetHash() const {
+  std::size_t hash = 0;
+  boost::hash_combine(hash, total_amount_.GetHash());
+  boost::hash_combine(hash, lines_.GetCount());
+  if (lines_.GetCount() > 0) {
+    boost::hash_combine(hash, line_hash_tree_.back().front());
+  }
+  return hash;
+}
+
+std::vector<size_t> Bill::GetChangedLines(const Bill &other) const {
+  std::vector<size_t> changed;
+  const std::vector<std::size_t> &hashes = line_hash_tree_.front();
+  const std::vector<std::size_t> &other_hashes = other.line_hash_tree_.front();
+  if (hashes.size() != other_hashes.size()) {
+    // The trees have different shapes, so compare line by line.
+    for (size_t pos = 0; pos < std::max(hashes.size(), other_hashes.size()); pos++) {
+      if (pos >= hashes.size() || pos >= other_hashes.size() || hashes[pos] != other_hashes[pos]) {
+        changed.push_back(pos);
+      }
+    }
+    return changed;
+  }
+
+  // Descend from the root into the branches that differ, depth first so positions come out in order.
+  std::vector<std::pair<size_t, size_t>> nodes;
+  if (!hashes.empty()) {
+    nodes.emplace_back(line_hash_tree_.size() - 1, 0);
+  }
+  while (!nodes.empty()) {
+    const auto [level, node] = nodes.back();
+    nodes.pop_back();
+    if (line_hash_tree_[level][node] == other.line_hash_tree_[level][node]) {
+      continue;
+    }
+    if (level == 0) {
+      changed.push_back(node);
+      continue;
+    }
+    if (node * 2 + 1 < line_hash_tree_[level - 1].size()) {
+      nodes.emplace_back(level - 1, node * 2 + 1);
+    }
+    nodes.emplace_back(level - 1, node * 2);
+  }
+  return changed;
+}
+
+void Bill::AddToTotals(const Money &amount, TaxRate tax_rate, bool split) {
+  if (amount.GetCurrencyCode() != usage_total_.GetCurrencyCode()) {
+    throw std::invalid_argument("Can only operate on money with the same currency");
+  }
+  auto bucket = std::find_if(tax_buckets_.begin(), tax_buckets_.end(), [tax_rate](const TaxBucket &bucket) {
+    return bucket.tax_rate == tax_rate;
+  });
+  if (bucket == tax_buckets_.end()) {
+    const Money zero(0, usage_total_.GetCurrencyCode());
+    bucket = tax_buckets_.insert(tax_buckets_.end(), TaxBucket{tax_rate, 0, zero, zero, zero, zero});
+  }
+  bucket->line_count++;
+  if (split) {
+    bucket->untaxed_usage = bucket->untaxed_usage + amount;
+  } else {
+    bucket->untaxed_general = bucket->untaxed_general + amount;
+  }
+  if (!IsBatching()) {
+    RetaxBucket(*bucket, split);
+  }
+}
+
+void Bill::RemoveFromTotals(const Money &amount, TaxRate tax_rate, bool split) {
+  const auto bucket = std::find_if(tax_buckets_.begin(), tax_buckets_.end(), [tax_rate](const TaxBucket &bucket) {
+    return bucket.tax_rate == tax_rate;
+  });
+  if (bucket == tax_buckets_.end()) {
+    throw std::invalid_argument("Line is not part of this bill");
+  }
+  if (--bucket->line_count == 0) {
+    // Drop the whole bucket so rates that are no longer used don't pile up.
+    usage_total_ = usage_total_ - bucket->usage;
+    general_total_ = general_total_ - bucket->general;
+    tax_buckets_.erase(bucket);
+    return;
+  }
+  if (split) {
+    bucket->untaxed_usage = bucket->untaxed_usage - amount;
+  } else {
+    bucket->untaxed_general = bucket->untaxed_general - amount;
+  }
+  if (!IsBatching()) {
+    RetaxBucket(*bucket, split);
+  }
+}
+
+void Bill::RetaxBucket(TaxBucket &bucket, bool split) {
+  if (split) {
+    usage_total_ = usage_total_ - bucket.usage;
+    bucket.usage = bucket.tax_rate.Apply(bucket.untaxed_usage);
+    usage_total_ = usage_total_ + bucket.usage;
+  } else {
+    general_total_ = general_total_ - bucket.general;
+    bucket.general = bucket.tax_rate.Apply(bucket.untaxed_general);
+    general_total_ = general_total_ + bucket.general;
+  }
+}
+
+void Bill::BeginBatch() {
+  if (batch_depth_++ == 0) {
+    rehash_first_ = lines_.GetCount();
+    rehash_last_ = 0;
+  }
+}
+
+void Bill::Commit() {
+  if (batch_depth_ == 0) {
+    throw std::logic_error("Commit() without BeginBatch()");
+  }
+  if (--batch_depth_ > 0) {
+    return;
+  }
+  for (auto &bucket : tax_buckets_) {
+    RetaxBucket(bucket, true);
+    RetaxBucket(bucket, false);
+  }
+  // Edits that shifted lines cover every line after them, so the union of the ranges covers everything that changed.
+  const size_t count = lines_.GetCount();
+  if (rehash_first_ <= rehash_last_) {
+    RehashLineTree(std::min(rehash_first_, count == 0 ? 0 : count - 1), std::min(rehash_last_, count));
+  }
+}
+
+void Bill::RehashLineTree(size_t first, size_t last) {
+  if (IsBatching()) {
+    rehash_first_ = std::min(rehash_first_, first);
+    rehash_last_ = std::max(rehash_last_, last);
+    return;
+  }
+  // Each node is the hash of its two children, or of its only child.  Only nodes above [first, last) change.
+  size_t level = 0;
+  while (line_hash_tree_[level].size() > 1) {
+    if (line_hash_tree_.size() == level + 1) {
+      line_hash_tree_.emplace_back();
+    }
+    const std::vector<std::size_t> &children = line_hash_tree_[level];
+    const size_t size = (children.size() + 1) / 2;
+    std::vector<std::size_t> &nodes = line_hash_tree_[level + 1];
+    nodes.resize(size);
+    first /= 2;
+    last = std::min((last + 1) / 2, size);
+    for (size_t node = first; node < last; node++) {
+      std::size_t hash = children[node * 2];
+      if (node * 2 + 1 < children.size()) {
+        boost::hash_combine(hash, children[node * 2 + 1]);
+      }
+      nodes[node] = hash;
     }
+    level++;
   }
+  line_hash_tree_.resize(level + 1);
 }
 
 } // splitbill
@@ -0,0 +1,205 @@
+/**
+ * @file BillLineStore.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include <stdexcept>
+#include "BillLineStore.h"
+
+namespace splitbill {
+
+namespace {
+
+/**
+ * Remove the elements at <positions> from <column>, moving each kept element once.
+ */
+template<class T>
+void EraseFromColumn(std::vector<T> &column, const std::vector<std::size_t> &positions) {
+  std::size_t next_removed = 0;
+  std::size_t kept = positions.front();
+  for (std::size_t pos = positions.front(); pos < column.size(); pos++) {
+    if (next_removed < positions.size() && positions[next_removed] == pos) {
+      next_removed++;
+      continue;
+    }
+    column[kept++] = std::move(column[pos]);
+  }
+  column.erase(column.begin() + kept, column.end());
+}
+
+} // namespace
+
+BillLine BillLineStore::Get(std::size_t pos) const {
+  BillLine line(currency_);
+  line.name = GetName(pos);
+  line.description = GetDescription(pos);
+  line.tax_rate = tax_rates_[pos];
+  line.amount = GetAmount(pos);
+  line.split = IsSplit(pos);
+  return line;
+}
+
+bool BillLineStore::Equals(std::size_t pos, const BillLine &line) const {
+  if (line.amount.GetCurrencyCode() != currency_ ||
+      amounts_.at(pos) != line.amount.GetDecimal() ||
+      tax_rates_[pos] != line.tax_rate ||
+      IsSplit(pos) != line.split) {
+    return false;
+  }
+  // Text that was never interned can't match any line.
+  const auto name = strings_.Find(line.name);
+  const auto description = strings_.Find(line.description);
+  return name && description && names_[pos] == *name && descriptions_[pos] == *description;
+}
+
+void BillLineStore::Insert(std::size_t pos, const BillLine &line) {
+  if (pos > GetCount()) {
+    throw std::out_of_range("Line position is past the end of the bill");
+  }
+  if (line.amount.GetCurrencyCode() != currency_) {
+    throw std::invalid_argument("Can only operate on money with the same currency");
+  }
+  amounts_.insert(amounts_.begin() + pos, line.amount.GetDecimal());
+  tax_rates_.insert(tax_rates_.begin() + pos, line.tax_rate);
+  names_.insert(names_.begin() + pos, strings_.Intern(line.name));
+  descriptions_.insert(descriptions_.begin() + pos, strings_.Intern(line.description));
+
+  // Shift the flags from <pos> up by one bit, carrying between words from the top down.
+  split_bits_.resize((GetCount() + kWordBits - 1) / kWordBits, 0);
+  const std::size_t word = pos / kWordBits;
+  for (std::size_t i = split_bits_.size() - 1; i > word; i--) {
+    split_bits_[i] = (split_bits_[i] << 1) | (split_bits_[i - 1] >> (kWordBits - 1));
+  }
+  const std::uint64_t below = (std::uint64_t(1) << (pos % kWordBits)) - 1;
+  split_bits_[word] = (split_bits_[word] & below) | ((split_bits_[word] & ~below) << 1);
+  SetSplit(pos, line.split);
+}
+
+void BillLineStore::Insert(std::size_t pos, const std::vector<BillLine> &lines) {
+  if (pos > GetCount()) {
+    throw std::out_of_range("Line position is past the end of the bill");
+  }
+  for (const auto &line : lines) {
+    if (line.amount.GetCurrencyCode() != currency_) {
+      throw std::invalid_argument("Can only operate on money with the same currency");
+    }
+  }
+  if (lines.empty()) {
+    return;
+  }
+
+  std::vector<Money::Decimal> amounts;
+  std::vector<TaxRate> tax_rates;
+  std::vector<StringId> names;
+  std::vector<StringId> descriptions;
+  amounts.reserve(lines.size());
+  tax_rates.reserve(lines.size());
+  names.reserve(lines.size());
+  descriptions.reserve(lines.size());
+  for (const auto &line : lines) {
+    amounts.push_back(line.amount.GetDecimal());
+    tax_rates.push_back(line.tax_rate);
+    names.push_back(strings_.Intern(line.name));
+    descriptions.push_back(strings_.Intern(line.description));
+  }
+  const std::size_t old_count = GetCount();
+  amounts_.insert(amounts_.begin() + pos, amounts.begin(), amounts.end());
+  tax_rates_.insert(tax_rates_.begin() + pos, tax_rates.begin(), tax_rates.end());
+  names_.insert(names_.begin() + pos, names.begin(), names.end());
+  descriptions_.insert(descriptions_.begin() + pos, descriptions.begin(), descriptions.end());
+
+  // Move the flags from <pos> up from the top down, so none is overwritten before it is read.
+  split_bits_.resize((GetCount() + kWordBits - 1) / kWordBits, 0);
+  for (std::size_t old_pos = old_count; old_pos > pos; old_pos--) {
+    SetSplit(old_pos - 1 + lines.size(), IsSplit(old_pos - 1));
+  }
+  for (std::size_t i = 0; i < lines.size(); i++) {
+    SetSplit(pos + i, lines[i].split);
+  }
+}
+
+void BillLineStore::Set(std::size_t pos, const BillLine &line) {
+  if (line.amount.GetCurrencyCode() != currency_) {
+    throw std::invalid_argument("Can only operate on money with the same currency");
+  }
+  amounts_.at(pos) = line.amount.GetDecimal();
+  tax_rates_[pos] = line.tax_rate;
+  // Intern before releasing, so text the line keeps isn't dropped and added again.
+  const StringId name = strings_.Intern(line.name);
+  const StringId description = strings_.Intern(line.description);
+  strings_.Release(names_[pos]);
+  strings_.Release(descriptions_[pos]);
+  names_[pos] = name;
+  descriptions_[pos] = description;
+  SetSplit(pos, line.split);
+}
+
+void BillLineStore::Erase(std::size_t pos) {
+  if (pos >= GetCount()) {
+    throw std::out_of_range("Line position is past the end of the bill");
+  }
+  strings_.Release(names_[pos]);
+  strings_.Release(descriptions_[pos]);
+  amounts_.erase(amounts_.begin() + pos);
+  tax_rates_.erase(tax_rates_.begin() + pos);
+  names_.erase(names_.begin() + pos);
+  descriptions_.erase(descriptions_.begin() + pos);
+
+  // Shift the flags above <pos> down by one bit, carrying between words from the bottom up.
+  const std::size_t word = pos / kWordBits;
+  const std::uint64_t below = (std::uint64_t(1) << (pos % kWordBits)) - 1;
+  split_bits_[word] = (split_bits_[word] & below) | ((split_bits_[word] >> 1) & ~below);
+  for (std::size_t i = word; i + 1 < split_bits_.size(); i++) {
+    split_bits_[i] |= (split_bits_[i + 1] & 1) << (kWordBits - 1);
+    split_bits_[i + 1] >>= 1;
+  }
+  split_bits_.resize((GetCount() + kWordBits - 1) / kWordBits);
+}
+
+void BillLineStore::Erase(const std::vector<std::size_t> &positions) {
+  if (positions.empty()) {
+    return;
+  }
+  if (positions.back() >= GetCount()) {
+    throw std::out_of_range("Line position is past the end of the bill");
+  }
+
+  for (const auto pos : positions) {
+    strings_.Release(names_[pos]);
+    strings_.Release(descriptions_[pos]);
+  }
+
+  // Flags are compacted in place; a kept flag never moves up.
+  std::size_t next_removed = 0;
+  std::size_t kept = positions.front();
+  for (std::size_t pos = positions.front(); pos < GetCount(); pos++) {
+    if (next_removed < positions.size() && positions[next_removed] == pos) {
+      next_removed++;
+      continue;
+    }
+    SetSplit(kept++, IsSplit(pos));
+  }
+  for (std::size_t pos = kept; pos < GetCount(); pos++) {
+    SetSplit(pos, false);
+  }
+  split_bits_.resize((kept + kWordBits - 1) / kWordBits);
+
+  EraseFromColumn(amounts_, positions);
+  EraseFromColumn(tax_rates_, positions);
+  EraseFromColumn(names_, positions);
+  EraseFromColumn(descriptions_, positions);
+}
+
+void BillLineStore::SetSplit(std::size_t pos, bool split) {
+  const std::uint64_t bit = std::uint64_t(1) << (pos % kWordBits);
+  if (split) {
+    split_bits_[pos / kWordBits] |= bit;
+  } else {
+    split_bits_[pos / kWordBits] &= ~bit;
+  }
+}
+
+} // splitbill
@@ -0,0 +1,244 @@
+/**
+ * @file IncrementalSplit.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include "IncrementalSplit.h"
+
+namespace splitbill {
+
+namespace {
+
+/**
+ * The days in <from> that are not in <to>, as at most two ranges.
+ */
+std::vector<Offsets> SubtractOffsets(const Offsets &from, const Offsets &to) {
+  std::vector<Offsets> ranges;
+  if (from.first == from.second) {
+    return ranges;
+  }
+  if (to.first == to.second) {
+    ranges.push_back(from);
+    return ranges;
+  }
+  const std::int64_t before_end = std::min(from.second, to.first);
+  if (from.first < before_end) {
+    ranges.emplace_back(from.first, before_end);
+  }
+  const std::int64_t after_start = std::max(from.first, to.second);
+  if (after_start < from.second) {
+    ranges.emplace_back(after_start, from.second);
+  }
+  return ranges;
+}
+
+} // namespace
+
+IncrementalSplit::IncrementalSplit(const Bill &bill,
+                                   const boost::gregorian::date_period &period,
+                                   std::vector<PersonPeriod> person_periods,
+                                   Roster roster) :
+    IncrementalSplit(bill.Total(), bill.GetCurrency().code, period, std::move(person_periods), std::move(roster)) {}
+
+IncrementalSplit::IncrementalSplit(const SplitBill &totals,
+                                   Currency::Code currency,
+                                   const boost::gregorian::date_period &period,
+                                   std::vector<PersonPeriod> person_periods,
+                                   Roster roster) :
+    period_(period), person_periods_(std::move(person_periods)), roster_(std::move(roster)),
+    usage_total_(0, currency), general_total_(0, currency) {
+  offsets_.reserve(person_periods_.size());
+  person_ids_.reserve(person_periods_.size());
+  for (const auto &person_period : person_periods_) {
+    offsets_.push_back(GetDayOffsets(period_, person_period.GetPeriod()));
+    person_ids_.push_back(GetPersonId(person_period));
+  }
+  SetBill(totals, currency);
+}
+
+void IncrementalSplit::SetBill(const SplitBill &totals, Currency::Code currency) {
+  if (totals.GetUsageTotal().GetCurrencyCode() != currency || totals.GetGeneralTotal().GetCurrencyCode() != currency) {
+    throw std::invalid_argument("Can only operate on money with the same currency");
+  }
+  general_total_ = totals.GetGeneralTotal();
+  usage_total_ = totals.GetUsageTotal();
+  Build();
+}
+
+void IncrementalSplit::UpdatePersonPeriod(std::size_t pos, const PersonPeriod &person_period) {
+  const Offsets old_offsets = offsets_.at(pos);
+  const PersonId old_person_id = person_ids_[pos];
+  const Offsets new_offsets = GetDayOffsets(period_, person_period.GetPeriod());
+  const PersonId new_person_id = GetPersonId(person_period);
+  const std::vector<Offsets> removed = SubtractOffsets(old_offsets, new_offsets);
+  const std::vector<Offsets> added = SubtractOffsets(new_offsets, old_offsets);
+
+  // Everyone else present on a day the period left or joined now shares it with one fewer or one more person.
+  const Money zero(0, usage_total_.GetCurrencyCode());
+  for (std::size_t i = 0; i < person_periods_.size(); i++) {
+    const PersonId person_id = person_ids_[i];
+    if (i == pos || person_id == kNoPersonId) {
+      continue;
+    }
+    const Offsets &offsets = offsets_[i];
+    Money change = zero;
+    for (const auto &range : removed) {
+      const std::int64_t last = std::min(range.second, offsets.second);
+      for (std::int64_t day = std::max(range.first, offsets.first); day < last; day++) {
+        change = change + (GetPartCost(occupancy_[day] - 1) - GetPartCost(occupancy_[day]));
+      }
+    }
+    for (const auto &range : added) {
+      const std::int64_t last = std::min(range.second, offsets.second);
+      for (std::int64_t day = std::max(range.first, offsets.first); day < last; day++) {
+        change = change + (GetPartCost(occupancy_[day] + 1) - GetPartCost(occupancy_[day]));
+      }
+    }
+    present_usages_[person_id] = present_usages_[person_id] + change;
+  }
+
+  // The edited period's own share
+  if (old_person_id != kNoPersonId) {
+    for (const auto &range : removed) {
+      for (std::int64_t day = range.first; day < range.second; day++) {
+        present_usages_[old_person_id] = present_usages_[old_person_id] - GetPartCost(occupancy_[day]);
+      }
+    }
+  }
+  if (old_person_id != new_person_id) {
+    // Days kept by the period move to the new person at the same cost.
+    const std::int64_t kept_last = std::min(old_offsets.second, new_offsets.second);
+    for (std::int64_t day = std::max(old_offsets.first, new_offsets.first); day < kept_last; day++) {
+      const Money cost = GetPartCost(occupancy_[day]);
+      if (old_person_id != kNoPersonId) {
+        present_usages_[old_person_id] = present_usages_[old_person_id] - cost;
+      }
+      if (new_person_id != kNoPersonId) {
+        present_usages_[new_person_id] = present_usages_[new_person_id] + cost;
+      }
+    }
+  }
+  if (new_person_id != kNoPersonId) {
+    for (const auto &range : added) {
+      for (std::int64_t day = range.first; day < range.second; day++) {
+        present_usages_[new_person_id] = present_usages_[new_person_id] + GetPartCost(occupancy_[day] + 1);
+      }
+    }
+  }
+
+  for (const auto &range : removed) {
+    for (std::int64_t day = range.first; day < range.second; day++) {
+      if (--occupancy_[day] == 0) {
+        empty_days_++;
+      }
+    }
+  }
+  for (const auto &range : added) {
+    for (std::int64_t day = range.first; day < range.second; day++) {
+      if (occupancy_[day]++ == 0) {
+        empty_days_--;
+      }
+    }
+  }
+
+  person_periods_[pos] = person_period;
+  offsets_[pos] = new_offsets;
+  person_ids_[pos] = new_person_id;
+}
+
+std::vector<BillPortion> IncrementalSplit::GetPortions() const {
+  const std::size_t person_count = roster_.GetPersonCount();
+  std::vector<BillPortion> portions;
+  if (person_count == 0) {
+    return portions;
+  }
+
+  // Days where no person was present are split among everyone.
+  const Money everyone_usage =
+      empty_days_ == 0 ? Money(0, usage_total_.GetCurrencyCode())
+                       : usage_total_.Scale(empty_days_, GetDayCount() * static_cast<std::int64_t>(person_count));
+  const Money general_chunk = general_total_ / person_count;
+  portions.reserve(person_count);
+  for (PersonId person_id = 0; person_id < person_count; person_id++) {
+    portions.emplace_back(person_id,
+                          roster_.GetName(person_id),
+                          everyone_usage + present_usages_[person_id],
+                          general_chunk);
+  }
+
+  return portions;
+}
+
+PersonId IncrementalSplit::GetPersonId(const PersonPeriod &person_period) const {
+  if (person_period.GetPersonId() != kNoPersonId) {
+    if (person_period.GetPersonId() >= roster_.GetPersonCount()) {
+      throw std::out_of_range("Person period refers to a person not in the roster");
+    }
+    return person_period.GetPersonId();
+  }
+  return roster_.Find(person_period.GetName()).value_or(kNoPersonId);
+}
+
+std::int64_t IncrementalSplit::GetDayCount() const {
+  return period_.is_null() ? 0 : std::max<std::int64_t>(period_.length().days(), 0);
+}
+
+Money IncrementalSplit::GetPartCost(unsigned int parts) {
+  while (part_costs_.size() <= parts) {
+    part_costs_.push_back(usage_total_.Scale(1, GetDayCount() * static_cast<std::int64_t>(part_costs_.size())));
+  }
+  return part_costs_[parts];
+}
+
+void IncrementalSplit::Build() {
+  const std::int64_t day_count = GetDayCount();
+  const Money zero(0, usage_total_.GetCurrencyCode());
+  part_costs_.assign(1, zero);
+
+  // Each period adds one on its first day and removes it the day after its last.
+  std::vector<long> changes(day_count + 1, 0);
+  for (const auto &[first, last] : offsets_) {
+    if (first == last) {
+      continue;
+    }
+    changes[first]++;
+    changes[last]--;
+  }
+  occupancy_.clear();
+  occupancy_.reserve(day_count);
+  empty_days_ = 0;
+  long occupancy = 0;
+  for (std::int64_t day = 0; day < day_count; day++) {
+    occupancy += changes[day];
+    occupancy_.push_back(occupancy);
+    if (occupancy == 0) {
+      empty_days_++;
+    }
+  }
+
+  // Each period's usage is the difference of two running sums of daily costs.
+  present_usages_.assign(roster_.GetPersonCount(), zero);
+  if (present_usages_.empty()) {
+    return;
+  }
+  std::vector<Money> cost_sums;
+  cost_sums.reserve(day_count + 1);
+  cost_sums.push_back(zero);
+  for (std::int64_t day = 0; day < day_count; day++) {
+    cost_sums.push_back(cost_sums.back() + GetPartCost(occupancy_[day]));
+  }
+  for (std::size_t i = 0; i < person_periods_.size(); i++) {
+    if (person_ids_[i] == kNoPersonId) {
+      continue;
+    }
+    const auto [first, last] = offsets_[i];
+    present_usages_[person_ids_[i]] = present_usages_[person_ids_[i]] + (cost_sums[last] - cost_sums[first]);
+  }
+}
+
+} // splitbill
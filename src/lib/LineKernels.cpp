@@ -0,0 +1,296 @@
+/**
+ * @file LineKernels.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "LineKernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SPLITBILL_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace splitbill {
+
+namespace {
+
+constexpr std::size_t kWordBits = 64;
+constexpr std::size_t kRatesPerPass = 4;
+// Lines copied out of the columns at a time.  A whole number of split words, and small enough to stay on the stack.
+constexpr std::size_t kBlockLines = 8 * kWordBits;
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 Wide;
+#else
+using Wide = boost::multiprecision::int128_t;
+#endif
+
+/**
+ * A sum of 64-bit amounts kept in parts that can't overflow for fewer than 2^32 lines.
+ *
+ * Each amount is read as unsigned and split into its low and high 32 bits, and negative amounts are counted so the
+ * 2^64 their unsigned reading added can be taken back off.  SIMD lanes can add all three with plain 64-bit adds.
+ */
+struct PartialSum {
+  std::uint64_t low = 0;
+  std::uint64_t high = 0;
+  std::uint64_t negative = 0;
+
+  void Add(std::uint64_t amount) {
+    low += amount & 0xFFFFFFFF;
+    high += amount >> 32;
+    negative += amount >> 63;
+  }
+
+  /**
+   * @throw std::overflow_error if the sum doesn't fit in 64 bits.
+   */
+  [[nodiscard]] std::int64_t Get() const {
+    const Wide sum = (Wide(high) << 32) + Wide(low) - (Wide(negative) << 64);
+    if (sum > Wide(std::numeric_limits<std::int64_t>::max()) || sum < Wide(std::numeric_limits<std::int64_t>::min())) {
+      throw std::overflow_error("Decimal value out of range");
+    }
+    return static_cast<std::int64_t>(sum);
+  }
+};
+
+/**
+ * Sums of the lines with one tax rate, before they are checked for overflow
+ */
+struct PartialLineSums {
+  PartialSum usage;
+  PartialSum general;
+  std::size_t line_count = 0;
+};
+
+/**
+ * Add lines [<begin>, <end>) to <sums>, one at a time.
+ */
+void SumLinesScalar(const std::int64_t *amounts,
+                    const std::int64_t *tax_rates,
+                    const std::uint64_t *split_bits,
+                    std::size_t begin,
+                    std::size_t end,
+                    const TaxRate *rates,
+                    PartialLineSums *sums,
+                    std::size_t rate_count) {
+  for (std::size_t rate = 0; rate < rate_count; rate++) {
+    const std::int64_t tax_rate = rates[rate].GetMillionths();
+    PartialLineSums &rate_sums = sums[rate];
+    for (std::size_t i = begin; i < end; i++) {
+      const std::uint64_t match = -static_cast<std::uint64_t>(tax_rates[i] == tax_rate);
+      const std::uint64_t split = -((split_bits[i / kWordBits] >> (i % kWordBits)) & 1);
+      const std::uint64_t amount = static_cast<std::uint64_t>(amounts[i]) & match;
+      rate_sums.usage.Add(amount & split);
+      rate_sums.general.Add(amount & ~split);
+      rate_sums.line_count += match & 1;
+    }
+  }
+}
+
+#ifdef SPLITBILL_X86_KERNELS
+
+/**
+ * Sum of the lanes of <value>
+ */
+__attribute__((target("sse4.1")))
+std::uint64_t AddLanes(__m128i value) {
+  alignas(16) std::uint64_t lanes[2];
+  _mm_store_si128(reinterpret_cast<__m128i *>(lanes), value);
+  return lanes[0] + lanes[1];
+}
+
+__attribute__((target("avx2")))
+std::uint64_t AddLanes(__m256i value) {
+  alignas(32) std::uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), value);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+/**
+ * Add lines [0, <count>) to <sums>, two at a time.  At most kRatesPerPass rates.
+ */
+__attribute__((target("sse4.1")))
+void SumLinesSse41(const std::int64_t *amounts,
+                   const std::int64_t *tax_rates,
+                   const std::uint64_t *split_bits,
+                   std::size_t count,
+                   const TaxRate *rates,
+                   PartialLineSums *sums,
+                   std::size_t rate_count) {
+  const __m128i lane_bits = _mm_set_epi64x(2, 1);
+  const __m128i low_mask = _mm_set1_epi64x(0xFFFFFFFF);
+  __m128i rate_values[kRatesPerPass];
+  // Low halves, high halves, and negative counts of usage then general
+  __m128i parts[kRatesPerPass][6];
+  __m128i line_count[kRatesPerPass];
+  for (std::size_t rate = 0; rate < rate_count; rate++) {
+    rate_values[rate] = _mm_set1_epi64x(rates[rate].GetMillionths());
+    for (auto &part : parts[rate]) {
+      part = _mm_setzero_si128();
+    }
+    line_count[rate] = _mm_setzero_si128();
+  }
+
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const __m128i amount = _mm_loadu_si128(reinterpret_cast<const __m128i *>(amounts + i));
+    const __m128i tax_rate = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tax_rates + i));
+    // Spread this pair's split bits across the lanes
+    const auto flags = static_cast<long long>((split_bits[i / kWordBits] >> (i % kWordBits)) & 0x3);
+    const __m128i split = _mm_cmpeq_epi64(_mm_and_si128(_mm_set1_epi64x(flags), lane_bits), lane_bits);
+    for (std::size_t rate = 0; rate < rate_count; rate++) {
+      const __m128i match = _mm_cmpeq_epi64(tax_rate, rate_values[rate]);
+      const __m128i matched = _mm_and_si128(amount, match);
+      const __m128i values[2] = {_mm_and_si128(matched, split), _mm_andnot_si128(split, matched)};
+      for (std::size_t kind = 0; kind < 2; kind++) {
+        __m128i *kind_parts = &parts[rate][kind * 3];
+        kind_parts[0] = _mm_add_epi64(kind_parts[0], _mm_and_si128(values[kind], low_mask));
+        kind_parts[1] = _mm_add_epi64(kind_parts[1], _mm_srli_epi64(values[kind], 32));
+        kind_parts[2] = _mm_add_epi64(kind_parts[2], _mm_srli_epi64(values[kind], 63));
+      }
+      line_count[rate] = _mm_sub_epi64(line_count[rate], match);
+    }
+  }
+
+  SumLinesScalar(amounts, tax_rates, split_bits, i, count, rates, sums, rate_count);
+  for (std::size_t rate = 0; rate < rate_count; rate++) {
+    PartialSum *kinds[2] = {&sums[rate].usage, &sums[rate].general};
+    for (std::size_t kind = 0; kind < 2; kind++) {
+      kinds[kind]->low += AddLanes(parts[rate][kind * 3]);
+      kinds[kind]->high += AddLanes(parts[rate][kind * 3 + 1]);
+      kinds[kind]->negative += AddLanes(parts[rate][kind * 3 + 2]);
+    }
+    sums[rate].line_count += AddLanes(line_count[rate]);
+  }
+}
+
+/**
+ * Add lines [0, <count>) to <sums>, four at a time.  At most kRatesPerPass rates.
+ */
+__attribute__((target("avx2")))
+void SumLinesAvx2(const std::int64_t *amounts,
+                  const std::int64_t *tax_rates,
+                  const std::uint64_t *split_bits,
+                  std::size_t count,
+                  const TaxRate *rates,
+                  PartialLineSums *sums,
+                  std::size_t rate_count) {
+  const __m256i lane_bits = _mm256_set_epi64x(8, 4, 2, 1);
+  const __m256i low_mask = _mm256_set1_epi64x(0xFFFFFFFF);
+  __m256i rate_values[kRatesPerPass];
+  // Low halves, high halves, and negative counts of usage then general
+  __m256i parts[kRatesPerPass][6];
+  __m256i line_count[kRatesPerPass];
+  for (std::size_t rate = 0; rate < rate_count; rate++) {
+    rate_values[rate] = _mm256_set1_epi64x(rates[rate].GetMillionths());
+    for (auto &part : parts[rate]) {
+      part = _mm256_setzero_si256();
+    }
+    line_count[rate] = _mm256_setzero_si256();
+  }
+
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256i amount = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(amounts + i));
+    const __m256i tax_rate = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tax_rates + i));
+    // Spread these four lines' split bits across the lanes
+    const auto flags = static_cast<long long>((split_bits[i / kWordBits] >> (i % kWordBits)) & 0xF);
+    const __m256i split = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(flags), lane_bits), lane_bits);
+    for (std::size_t rate = 0; rate < rate_count; rate++) {
+      const __m256i match = _mm256_cmpeq_epi64(tax_rate, rate_values[rate]);
+      const __m256i matched = _mm256_and_si256(amount, match);
+      const __m256i values[2] = {_mm256_and_si256(matched, split), _mm256_andnot_si256(split, matched)};
+      for (std::size_t kind = 0; kind < 2; kind++) {
+        __m256i *kind_parts = &parts[rate][kind * 3];
+        kind_parts[0] = _mm256_add_epi64(kind_parts[0], _mm256_and_si256(values[kind], low_mask));
+        kind_parts[1] = _mm256_add_epi64(kind_parts[1], _mm256_srli_epi64(values[kind], 32));
+        kind_parts[2] = _mm256_add_epi64(kind_parts[2], _mm256_srli_epi64(values[kind], 63));
+      }
+      line_count[rate] = _mm256_sub_epi64(line_count[rate], match);
+    }
+  }
+
+  SumLinesScalar(amounts, tax_rates, split_bits, i, count, rates, sums, rate_count);
+  for (std::size_t rate = 0; rate < rate_count; rate++) {
+    PartialSum *kinds[2] = {&sums[rate].usage, &sums[rate].general};
+    for (std::size_t kind = 0; kind < 2; kind++) {
+      kinds[kind]->low += AddLanes(parts[rate][kind * 3]);
+      kinds[kind]->high += AddLanes(parts[rate][kind * 3 + 1]);
+      kinds[kind]->negative += AddLanes(parts[rate][kind * 3 + 2]);
+    }
+    sums[rate].line_count += AddLanes(line_count[rate]);
+  }
+}
+
+#endif
+
+} // namespace
+
+SimdLevel GetSimdLevel() {
+#ifdef SPLITBILL_X86_KERNELS
+  static const SimdLevel level = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return SimdLevel::kAvx2;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+      return SimdLevel::kSse41;
+    }
+    return SimdLevel::kScalar;
+  }();
+  return level;
+#else
+  return SimdLevel::kScalar;
+#endif
+}
+
+void SumLinesByTaxRate(const FixedDecimal *amounts,
+                       const TaxRate *tax_rates,
+                       const std::uint64_t *split_bits,
+                       std::size_t count,
+                       const TaxRate *rates,
+                       LineSums *sums,
+                       std::size_t rate_count,
+                       SimdLevel level) {
+  std::vector<PartialLineSums> partial_sums(rate_count);
+  std::int64_t raw_amounts[kBlockLines];
+  std::int64_t raw_tax_rates[kBlockLines];
+  for (std::size_t block = 0; block < count; block += kBlockLines) {
+    const std::size_t block_count = std::min(kBlockLines, count - block);
+    for (std::size_t i = 0; i < block_count; i++) {
+      raw_amounts[i] = amounts[block + i].GetRaw();
+      raw_tax_rates[i] = tax_rates[block + i].GetMillionths();
+    }
+    const std::uint64_t *block_split_bits = split_bits + block / kWordBits;
+    for (std::size_t first = 0; first < rate_count; first += kRatesPerPass) {
+      const std::size_t pass_rates = std::min(kRatesPerPass, rate_count - first);
+      PartialLineSums *pass_sums = partial_sums.data() + first;
+#ifdef SPLITBILL_X86_KERNELS
+      if (level == SimdLevel::kAvx2) {
+        SumLinesAvx2(raw_amounts, raw_tax_rates, block_split_bits, block_count, rates + first, pass_sums, pass_rates);
+        continue;
+      } else if (level == SimdLevel::kSse41) {
+        SumLinesSse41(raw_amounts, raw_tax_rates, block_split_bits, block_count, rates + first, pass_sums, pass_rates);
+        continue;
+      }
+#endif
+      SumLinesScalar(raw_amounts, raw_tax_rates, block_split_bits, 0, block_count, rates + first, pass_sums,
+                     pass_rates);
+    }
+  }
+
+  for (std::size_t rate = 0; rate < rate_count; rate++) {
+    sums[rate].usage = partial_sums[rate].usage.Get();
+    sums[rate].general = partial_sums[rate].general.Get();
+    sums[rate].line_count = partial_sums[rate].line_count;
+  }
+}
+
+} // splitbill
@@ -9,19 +9,31 @@
 #include "Money.h"
 #include <cmath>
 #include <stdexcept>
+#include <boost/container_hash/hash.hpp>
 
 namespace splitbill {
 
-Money::Money(const double &value, Currency::Info currency) :
-    currency_(std::move(currency)), value_(value) {}
+Money::Money(const double &value, Currency::Code currency) :
+    currency_(currency), value_(value) {}
 
 double Money::GetValue() const {
-  const unsigned int multiplier = currency_.multiplier();
+  const unsigned int multiplier = GetCurrency().multiplier();
+#ifdef SPLITBILL_MONEY_DECIMAL
   return std::round((value_ * multiplier).convert_to<double>()) / multiplier;
+#else
+  return static_cast<double>(value_.Round(multiplier)) / multiplier;
+#endif
 }
 
-const Currency::Info &Money::GetCurrency() const {
-  return currency_;
+std::size_t Money::GetHash() const {
+  std::size_t hash = 0;
+  boost::hash_combine(hash, currency_);
+#ifdef SPLITBILL_MONEY_DECIMAL
+  boost::hash_combine(hash, value_.str());
+#else
+  boost::hash_combine(hash, value_.GetRaw());
+#endif
+  return hash;
 }
 
 bool Money::operator==(const Money &rhs) const {
@@ -99,4 +111,15 @@ MONEY_OP(/)
 
 #undef MONEY_OP
 
+Money Money::Scale(std::int64_t numerator, std::int64_t denominator) const {
+#ifdef SPLITBILL_MONEY_DECIMAL
+  if (denominator == 0) {
+    throw std::domain_error("Division by zero");
+  }
+  return Money(value_ * numerator / denominator, currency_);
+#else
+  return Money(value_.Scale(numerator, denominator), currency_);
+#endif
+}
+
 } // splitbill
@@ -0,0 +1,129 @@
+/**
+ * @file Occupancy.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include <algorithm>
+#include "Occupancy.h"
+#include "Bill.h"
+
+namespace splitbill {
+
+Offsets GetDayOffsets(const boost::gregorian::date_period &billing_period,
+                      const boost::gregorian::date_period &period) {
+  const boost::gregorian::date_period clipped = period.intersection(billing_period);
+  if (clipped.is_null()) {
+    return {0, 0};
+  }
+  return {(clipped.begin() - billing_period.begin()).days(), (clipped.end() - billing_period.begin()).days()};
+}
+
+Offsets GetTimeOffsets(const boost::posix_time::time_period &billing_period,
+                       const boost::posix_time::time_period &period,
+                       const boost::posix_time::time_duration &resolution) {
+  const boost::posix_time::time_period clipped = period.intersection(billing_period);
+  if (clipped.is_null()) {
+    return {0, 0};
+  }
+  const std::int64_t unit = resolution.ticks();
+  const std::int64_t first = (clipped.begin() - billing_period.begin()).ticks();
+  const std::int64_t last = (clipped.end() - billing_period.begin()).ticks();
+  return {first / unit, (last + unit - 1) / unit};
+}
+
+DayOccupancy::DayOccupancy(const boost::gregorian::date_period &period,
+                           const std::vector<PersonPeriod> &person_periods) {
+  const long day_count = period.length().days();
+  if (period.is_null() || day_count <= 0) {
+    return;
+  }
+
+  // Each period adds one on its first day and removes it the day after its last.
+  std::vector<long> changes(day_count + 1, 0);
+  for (const auto &person_period : person_periods) {
+    const auto [first, last] = GetDayOffsets(period, person_period.GetPeriod());
+    if (first == last) {
+      continue;
+    }
+    changes[first]++;
+    changes[last]--;
+  }
+
+  occupancy_.reserve(day_count);
+  long occupancy = 0;
+  for (long day = 0; day < day_count; day++) {
+    occupancy += changes[day];
+    occupancy_.push_back(occupancy);
+    if (occupancy == 0) {
+      empty_length_++;
+    }
+  }
+}
+
+IntervalOccupancy::IntervalOccupancy(std::int64_t length, const std::vector<Offsets> &intervals) {
+  Build(length, intervals);
+}
+
+IntervalOccupancy::IntervalOccupancy(const boost::gregorian::date_period &period,
+                                     const std::vector<PersonPeriod> &person_periods) {
+  std::vector<Offsets> intervals;
+  intervals.reserve(person_periods.size());
+  for (const auto &person_period : person_periods) {
+    intervals.push_back(GetDayOffsets(period, person_period.GetPeriod()));
+  }
+  Build(period.is_null() ? 0 : period.length().days(), intervals);
+}
+
+void IntervalOccupancy::Build(std::int64_t length, const std::vector<Offsets> &intervals) {
+  if (length <= 0) {
+    return;
+  }
+
+  breakpoints_.reserve(intervals.size() * 2 + 2);
+  breakpoints_.push_back(0);
+  breakpoints_.push_back(length);
+  for (const auto &[first, last] : intervals) {
+    if (first == last) {
+      continue;
+    }
+    breakpoints_.push_back(first);
+    breakpoints_.push_back(last);
+  }
+  std::sort(breakpoints_.begin(), breakpoints_.end());
+  breakpoints_.erase(std::unique(breakpoints_.begin(), breakpoints_.end()), breakpoints_.end());
+
+  // Same difference array as DayOccupancy, but over segments instead of days.
+  std::vector<long> changes(breakpoints_.size(), 0);
+  for (const auto &interval : intervals) {
+    if (interval.first == interval.second) {
+      continue;
+    }
+    const auto [first, last] = GetSegments(interval);
+    changes[first]++;
+    changes[last]--;
+  }
+
+  occupancy_.reserve(breakpoints_.size() - 1);
+  long occupancy = 0;
+  for (std::size_t segment = 0; segment + 1 < breakpoints_.size(); segment++) {
+    occupancy += changes[segment];
+    occupancy_.push_back(occupancy);
+    if (occupancy == 0) {
+      empty_length_ += GetSegmentLength(segment);
+    }
+  }
+}
+
+std::pair<std::size_t, std::size_t> IntervalOccupancy::GetSegments(const Offsets &offsets) const {
+  if (offsets.first == offsets.second) {
+    return {0, 0};
+  }
+  const auto first = std::lower_bound(breakpoints_.cbegin(), breakpoints_.cend(), offsets.first);
+  const auto last = std::lower_bound(first, breakpoints_.cend(), offsets.second);
+  return {first - breakpoints_.cbegin(), last - breakpoints_.cbegin()};
+}
+
+} // splitbill
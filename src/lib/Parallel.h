@@ -0,0 +1,80 @@
+/**
+ * @file Parallel.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_SRC_LIB_PARALLEL_H_
+#define SPLITBILL_SRC_LIB_PARALLEL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace splitbill {
+
+/**
+ * Resolve a requested thread count, where 0 means one per core.
+ * @param threads
+ * @return
+ */
+inline unsigned int GetThreadCount(unsigned int threads) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  return std::max(threads, 1u);
+}
+
+/**
+ * Call <function>(begin, end) on contiguous chunks of [0, <count>), one chunk per thread.
+ *
+ * Chunk boundaries only depend on <count> and <threads>.  The first exception thrown by any chunk is rethrown once all
+ * threads have finished.
+ *
+ * @param count
+ * @param threads
+ * @param function
+ */
+template<class Function>
+void ParallelFor(std::size_t count, unsigned int threads, const Function &function) {
+  threads = static_cast<unsigned int>(std::min<std::size_t>(threads, count));
+  if (threads <= 1) {
+    function(std::size_t(0), count);
+    return;
+  }
+
+  const std::size_t chunk_size = (count + threads - 1) / threads;
+  std::vector<std::exception_ptr> errors(threads);
+  const auto run_chunk = [&](unsigned int chunk) {
+    try {
+      const std::size_t begin = std::min(chunk * chunk_size, count);
+      function(begin, std::min(begin + chunk_size, count));
+    } catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (unsigned int chunk = 1; chunk < threads; chunk++) {
+    workers.emplace_back(run_chunk, chunk);
+  }
+  run_chunk(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+} // splitbill
+
+#endif //SPLITBILL_SRC_LIB_PARALLEL_H_
@@ -0,0 +1,95 @@
+/**
+ * @file PresenceCalendar.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include "PresenceCalendar.h"
+#include "Bill.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace splitbill {
+
+namespace {
+
+unsigned int PopCount(std::uint64_t bits) {
+#ifdef _MSC_VER
+  return static_cast<unsigned int>(__popcnt64(bits));
+#else
+  return __builtin_popcountll(bits);
+#endif
+}
+
+/**
+ * Index of the lowest set bit.  <bits> must not be zero.
+ */
+unsigned int LowestBit(std::uint64_t bits) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, bits);
+  return static_cast<unsigned int>(index);
+#else
+  return __builtin_ctzll(bits);
+#endif
+}
+
+} // namespace
+
+PresenceCalendar::PresenceCalendar(const boost::gregorian::date_period &period,
+                                   const std::vector<PersonPeriod> &person_periods) {
+  const long day_count = period.is_null() ? 0 : period.length().days();
+  if (day_count <= 0) {
+    return;
+  }
+
+  row_count_ = person_periods.size();
+  word_count_ = (row_count_ + 63) / 64;
+  columns_.assign(day_count * word_count_, 0);
+  for (std::size_t row = 0; row < row_count_; row++) {
+    const auto [first, last] = GetDayOffsets(period, person_periods[row].GetPeriod());
+    const std::uint64_t bit = std::uint64_t(1) << (row % 64);
+    for (auto day = static_cast<std::size_t>(first); day < static_cast<std::size_t>(last); day++) {
+      columns_[day * word_count_ + row / 64] |= bit;
+    }
+  }
+
+  occupancy_.reserve(day_count);
+  for (std::size_t day = 0; day < static_cast<std::size_t>(day_count); day++) {
+    unsigned int occupancy = 0;
+    for (std::size_t word = 0; word < word_count_; word++) {
+      occupancy += PopCount(columns_[day * word_count_ + word]);
+    }
+    occupancy_.push_back(occupancy);
+    if (occupancy == 0) {
+      empty_length_++;
+    }
+  }
+}
+
+void PresenceCalendar::AddPresentCosts(const Money *day_costs,
+                                       std::size_t cost_count,
+                                       std::size_t first_word,
+                                       std::size_t last_word,
+                                       Money *row_costs) const {
+  for (std::size_t day = 0; day < occupancy_.size(); day++) {
+    if (occupancy_[day] == 0) {
+      continue;
+    }
+    const std::uint64_t *column = &columns_[day * word_count_];
+    const Money *costs = &day_costs[day * cost_count];
+    for (std::size_t word = first_word; word < last_word; word++) {
+      for (std::uint64_t bits = column[word]; bits != 0; bits &= bits - 1) {
+        Money *row_cost = &row_costs[(word * 64 + LowestBit(bits)) * cost_count];
+        for (std::size_t i = 0; i < cost_count; i++) {
+          row_cost[i] = row_cost[i] + costs[i];
+        }
+      }
+    }
+  }
+}
+
+} // splitbill
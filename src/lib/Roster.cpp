@@ -0,0 +1,37 @@
+/**
+ * @file Roster.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include "Roster.h"
+
+namespace splitbill {
+
+Roster::Roster(const std::vector<std::string> &people) {
+  names_.reserve(people.size());
+  ids_.reserve(people.size());
+  for (const auto &person : people) {
+    Add(person);
+  }
+}
+
+PersonId Roster::Add(const std::string &name) {
+  const auto [it, inserted] = ids_.try_emplace(name, static_cast<PersonId>(names_.size()));
+  if (inserted) {
+    names_.push_back(name);
+  }
+  return it->second;
+}
+
+std::optional<PersonId> Roster::Find(const std::string &name) const {
+  const auto it = ids_.find(name);
+  if (it == ids_.end()) {
+    return {};
+  }
+  return it->second;
+}
+
+} // splitbill
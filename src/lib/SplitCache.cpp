@@ -0,0 +1,96 @@
+/**
+ * @file SplitCache.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include <iterator>
+#include <boost/container_hash/hash.hpp>
+#include "SplitCache.h"
+
+namespace splitbill {
+
+bool SplitCache::Key::operator==(const Key &rhs) const {
+  return usage_total == rhs.usage_total &&
+      general_total == rhs.general_total &&
+      period == rhs.period &&
+      person_periods == rhs.person_periods &&
+      people == rhs.people &&
+      mode == rhs.mode;
+}
+
+std::size_t SplitCache::Key::GetHash() const {
+  std::size_t hash = 0;
+  boost::hash_combine(hash, usage_total.GetHash());
+  boost::hash_combine(hash, general_total.GetHash());
+  boost::hash_combine(hash, period.begin().day_number());
+  boost::hash_combine(hash, period.end().day_number());
+  for (const auto &person_period : person_periods) {
+    boost::hash_combine(hash, person_period.GetHash());
+  }
+  for (const auto &person : people) {
+    boost::hash_combine(hash, person);
+  }
+  boost::hash_combine(hash, static_cast<int>(mode));
+  return hash;
+}
+
+SplitCache::SplitCache(std::size_t capacity) :
+    capacity_(capacity) {}
+
+std::vector<BillPortion> SplitCache::Split(const Bill &bill,
+                                           const boost::gregorian::date_period &period,
+                                           const std::vector<PersonPeriod> &person_periods,
+                                           const Roster &roster,
+                                           const SplitOptions &options) {
+  const SplitBill totals = bill.Total();
+  Key key{totals.GetUsageTotal(), totals.GetGeneralTotal(), period, person_periods, roster.GetNames(), options.mode};
+  const std::size_t hash = key.GetHash();
+  const auto [first, last] = index_.equal_range(hash);
+  for (auto it = first; it != last; ++it) {
+    if (it->second->key == key) {
+      hit_count_++;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return entries_.front().portions;
+    }
+  }
+
+  miss_count_++;
+  std::vector<BillPortion> portions = bill.Split(period, person_periods, roster, options);
+  if (capacity_ > 0) {
+    entries_.push_front(Entry{std::move(key), hash, portions});
+    index_.emplace(hash, entries_.begin());
+    Evict();
+  }
+  return portions;
+}
+
+void SplitCache::SetCapacity(std::size_t capacity) {
+  capacity_ = capacity;
+  Evict();
+}
+
+void SplitCache::Clear() {
+  entries_.clear();
+  index_.clear();
+  hit_count_ = 0;
+  miss_count_ = 0;
+}
+
+void SplitCache::Evict() {
+  while (entries_.size() > capacity_) {
+    const auto oldest = std::prev(entries_.end());
+    const auto [first, last] = index_.equal_range(oldest->hash);
+    for (auto it = first; it != last; ++it) {
+      if (it->second == oldest) {
+        index_.erase(it);
+        break;
+      }
+    }
+    entries_.pop_back();
+  }
+}
+
+} // splitbill
@@ -0,0 +1,74 @@
+/**
+ * @file StringPool.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include <stdexcept>
+#include "StringPool.h"
+
+namespace splitbill {
+
+StringPool::StringPool(const StringPool &other) :
+    strings_(other.strings_), references_(other.references_), free_ids_(other.free_ids_) {
+  // The index must refer to this pool's copies.
+  ids_.reserve(other.ids_.size());
+  for (StringId id = 0; id < strings_.size(); id++) {
+    if (references_[id] > 0) {
+      ids_.emplace(strings_[id], id);
+    }
+  }
+}
+
+StringPool &StringPool::operator=(const StringPool &other) {
+  if (this != &other) {
+    *this = StringPool(other);
+  }
+  return *this;
+}
+
+StringId StringPool::Intern(std::string_view value) {
+  const auto found = ids_.find(value);
+  if (found != ids_.end()) {
+    references_[found->second]++;
+    return found->second;
+  }
+  StringId id;
+  if (free_ids_.empty()) {
+    id = static_cast<StringId>(strings_.size());
+    strings_.emplace_back(value);
+    references_.push_back(1);
+  } else {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+    strings_[id] = value;
+    references_[id] = 1;
+  }
+  ids_.emplace(strings_[id], id);
+  return id;
+}
+
+void StringPool::Release(StringId id) {
+  if (references_.at(id) == 0) {
+    throw std::logic_error("Released a string with no references");
+  }
+  if (--references_[id] > 0) {
+    return;
+  }
+  ids_.erase(strings_[id]);
+  // Give the memory back; short strings stay in the object itself.
+  std::string().swap(strings_[id]);
+  free_ids_.push_back(id);
+}
+
+std::optional<StringId> StringPool::Find(std::string_view value) const {
+  const auto found = ids_.find(value);
+  if (found == ids_.end()) {
+    return {};
+  }
+  return found->second;
+}
+
+} // splitbill
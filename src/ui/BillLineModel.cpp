@@ -5,8 +5,10 @@
  * @date 6/5/20
  */
 
-#include <QtCore/QSet>
+#include <algorithm>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 #include "BillLineModel.h"
 #include "Settings.h"
 
@@ -22,6 +24,7 @@ const std::unordered_map<BillLineModel::Column, QString> BillLineModel::kColumnN
 
 BillLineModel::BillLineModel(QSharedPointer<Bill> bill, QObject *parent) :
     QAbstractTableModel(parent), bill_(std::move(bill)) {
+  display_cache_.Track(this);
 }
 
 int BillLineModel::rowCount(const QModelIndex &parent) const {
@@ -59,26 +62,37 @@ QVariant BillLineModel::headerData(int section, Qt::Orientation orientation, int
 
 QVariant BillLineModel::data(const QModelIndex &index, int role) const {
   const auto column = static_cast<Column>(index.column());
-  const BillLine &line = bill_->GetLine(index.row());
+  const BillLineStore &lines = bill_->GetLineStore();
 
   if (role == Qt::ItemDataRole::DisplayRole) {
+    if (column == Column::kIsSplit) {
+      //: Bill line usage
+      return lines.IsSplit(index.row()) ? tr("Yes") : tr("No");
+    }
+    const LineDisplay &display = display_cache_.Get(index.row(), [this, &lines, &index]() {
+      const size_t pos = index.row();
+      return LineDisplay{
+          QString::fromStdString(lines.GetName(pos)),
+          QString::fromStdString(lines.GetDescription(pos)),
+          locale_.toCurrencyString(lines.GetAmount(pos).GetValue()),
+          locale_.toString(lines.GetTaxRate(pos).ToDouble() * 100, 'f', 3) + locale_.percent(),
+      };
+    });
     if (column == Column::kName) {
-      return QString::fromStdString(line.name);
+      return display.name;
     } else if (column == Column::kDescription) {
-      return QString::fromStdString(line.description);
+      return display.description;
     } else if (column == Column::kAmount) {
-      return QLocale().toCurrencyString(line.amount.GetValue());
+      return display.amount;
     } else if (column == Column::kTaxRate) {
-      return QLocale().toString(line.tax_rate * 100, 'f', 3) + QLocale().percent();
-    } else if (column == Column::kIsSplit) {
-      //: Bill line usage
-      return line.split ? tr("Yes") : tr("No");
+      return display.tax_rate;
     }
   } else if (role == Qt::ItemDataRole::CheckStateRole) {
     if (column == Column::kIsSplit) {
-      return line.split ? Qt::CheckState::Checked : Qt::CheckState::Unchecked;
+      return lines.IsSplit(index.row()) ? Qt::CheckState::Checked : Qt::CheckState::Unchecked;
     }
   } else if (role == Qt::ItemDataRole::EditRole) {
+    const BillLine line = bill_->GetLine(index.row());
     if (column == Column::kName) {
       return QString::fromStdString(line.name);
     } else if (column == Column::kDescription) {
@@ -86,7 +100,7 @@ QVariant BillLineModel::data(const QModelIndex &index, int role) const {
     } else if (column == Column::kAmount) {
       return line.amount.GetValue();
     } else if (column == Column::kTaxRate) {
-      return line.tax_rate;
+      return line.tax_rate.ToDouble();
     } else if (column == Column::kIsSplit) {
       return line.split;
     }
@@ -108,7 +122,7 @@ bool BillLineModel::setData(const QModelIndex &index, const QVariant &value, int
       line.description = value.toString().toStdString();
       success = true;
     } else if (column == Column::kAmount) {
-      line.amount = Money(value.toDouble(&success), QLocale().currencySymbol(QLocale::CurrencyIsoCode).toStdString());
+      line.amount = Money(value.toDouble(&success), locale_.currencySymbol(QLocale::CurrencyIsoCode).toStdString());
     } else if (column == Column::kTaxRate) {
       line.tax_rate = value.toDouble(&success);
     } else if (column == Column::kIsSplit) {
@@ -140,7 +154,7 @@ void BillLineModel::AddLine(const BillLine &line) {
 
 void BillLineModel::AddLine(const QModelIndex &index) {
   const QModelIndex parent;
-  BillLine line(QLocale().currencySymbol(QLocale::CurrencyIsoCode).toStdString());
+  BillLine line(locale_.currencySymbol(QLocale::CurrencyIsoCode).toStdString());
   line.tax_rate = Settings::GetDefaultTaxRate();
 
   if (index.isValid()) {
@@ -155,6 +169,43 @@ void BillLineModel::AddLine(const QModelIndex &index) {
   endInsertRows();
 }
 
+void BillLineModel::AddLines(const std::vector<BillLine> &lines, const QModelIndex &index) {
+  if (lines.empty()) {
+    return;
+  }
+  // Reject bad lines before views are told rows are coming.
+  for (const auto &line : lines) {
+    if (line.amount.GetCurrencyCode() != bill_->GetCurrency().code) {
+      throw std::invalid_argument("Can only operate on money with the same currency");
+    }
+  }
+  const QModelIndex parent;
+  const int pos = index.isValid() ? index.row() : rowCount(parent);
+  beginInsertRows(parent, pos, pos + static_cast<int>(lines.size()) - 1);
+  try {
+    bill_->InsertLines(lines, pos);
+  } catch (...) {
+    // The insert can't be described any more, so close it and have views start over.
+    endInsertRows();
+    beginResetModel();
+    endResetModel();
+    throw;
+  }
+  endInsertRows();
+}
+
+void BillLineModel::EditLines(const std::function<void(Bill &)> &edit) {
+  beginResetModel();
+  try {
+    Bill::Batch batch(*bill_);
+    edit(*bill_);
+  } catch (...) {
+    endResetModel();
+    throw;
+  }
+  endResetModel();
+}
+
 void BillLineModel::RemoveLine(const BillLine &line) {
   // Need to know where the line is to emit the proper signal
   for (size_t i = 0; i < bill_->GetLineCount(); i++) {
@@ -180,28 +231,32 @@ void BillLineModel::RemoveLine(const QModelIndex &index) {
 }
 
 void BillLineModel::RemoveLines(const QModelIndexList &indexes) {
-  // Get the rows affected
-  QSet<int> selected_rows;
+  // Get the rows affected, in order
+  std::vector<std::size_t> rows;
   for (const auto &index : indexes) {
     if (index.isValid()) {
-      selected_rows.insert(index.row());
+      rows.push_back(index.row());
     }
   }
-  if (selected_rows.empty()) {
+  if (rows.empty()) {
     return;
   }
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
 
-  QList<int> row_list = selected_rows.values();
-  // Reverse sort the list to remove the last affected row first.  This keeps indexes consistent.
-  std::sort(row_list.begin(), row_list.end(), std::greater<>());
-  const QModelIndex parent;
-  const int first_row = row_list.last();
-  const int last_row = row_list.first();
-  beginRemoveRows(parent, first_row, last_row);
-  for (const auto &row : selected_rows) {
-    bill_->RemoveLine(row);
+  // A gap in the selection would need a signal per range, so reset the view instead.
+  const bool contiguous = rows.back() - rows.front() + 1 == rows.size();
+  if (contiguous) {
+    beginRemoveRows(QModelIndex(), static_cast<int>(rows.front()), static_cast<int>(rows.back()));
+  } else {
+    beginResetModel();
+  }
+  bill_->RemoveLines(rows);
+  if (contiguous) {
+    endRemoveRows();
+  } else {
+    endResetModel();
   }
-  endRemoveRows();
 }
 
 } // splitbill::ui
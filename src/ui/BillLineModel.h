@@ -9,10 +9,14 @@
 #define SPLITBILL_SRC_UI_BILLLINEMODEL_H_
 
 #include <QtCore/QAbstractTableModel>
+#include <QtCore/QLocale>
 #include <QSharedPointer>
+#include <functional>
 #include <unordered_map>
+#include <vector>
 #include <lib/Bill.h>
 #include "BillLineDelegate.h"
+#include "RowCache.h"
 
 namespace splitbill::ui {
 
@@ -36,6 +40,17 @@ class BillLineModel : public QAbstractTableModel {
   void AddLine(const BillLine &line);
   void AddLine(const QModelIndex &index = QModelIndex());
 
+  /**
+   * Insert <lines> before <index>, or at the end, with a single notification.
+   * @throw std::invalid_argument if a line isn't in the bill's currency; the model is left untouched.
+   */
+  void AddLines(const std::vector<BillLine> &lines, const QModelIndex &index = QModelIndex());
+
+  /**
+   * Make any number of edits to the bill in one batch.  Views are reset once afterwards.
+   */
+  void EditLines(const std::function<void(Bill &)> &edit);
+
   void RemoveLine(const BillLine &line);
   void RemoveLine(const size_t &pos);
   void RemoveLine(const QModelIndex &index);
@@ -53,6 +68,18 @@ class BillLineModel : public QAbstractTableModel {
   static const unsigned int kColumnCount = static_cast<unsigned int>(Column::kIsSplit) + 1;
 
   static const std::unordered_map<Column, QString> kColumnNames;
+
+  /**
+   * A line's display strings
+   */
+  struct LineDisplay {
+    QString name;
+    QString description;
+    QString amount;
+    QString tax_rate;
+  };
+  const QLocale locale_;
+  mutable RowCache<LineDisplay> display_cache_;
 };
 
 } // splitbill::ui
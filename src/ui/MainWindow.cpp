@@ -28,6 +28,10 @@ MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
     bill_(new Bill(QLocale().currencySymbol(QLocale::CurrencyIsoCode).toStdString())),
     people_(new QVector<PersonPeriod>) {
+  recompute_timer_ = new QTimer(this);
+  recompute_timer_->setSingleShot(true);
+  recompute_timer_->setInterval(0);
+  connect(recompute_timer_, &QTimer::timeout, this, &MainWindow::SRecompute);
   InitUi();
   InitMenu();
 }
@@ -65,8 +69,6 @@ void MainWindow::InitUi() {
   //: Bill line total label
   line_info_layout->addWidget(new QLabel(tr("Line Total:")));
   widgets_.billLineTotalLabel = new QLabel;
-  SUpdateLineTotal();
-  connect(bill_line_model_, &BillLineModel::dataChanged, this, &MainWindow::SUpdateLineTotal);
   line_info_layout->addWidget(widgets_.billLineTotalLabel);
 
   // Add/Remove Buttons
@@ -98,8 +100,10 @@ void MainWindow::InitUi() {
   widgets_.billIsValidLabel->setWordWrap(true);
   bill_valid_layout->addWidget(widgets_.billIsValidLabel);
   bill_valid_layout->addStretch();
-  SUpdateBillValidation();
-  connect(bill_line_model_, &BillLineModel::dataChanged, this, &MainWindow::SUpdateBillValidation);
+  // Render the status icons once
+  static const QSize icon_size = QSize(16, 16);
+  good_icon_ = QIcon(":/good").pixmap(icon_size);
+  bad_icon_ = QIcon(":/bad").pixmap(icon_size);
   connect(widgets_.billTotalEntry,
           QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &MainWindow::SUpdateBillTotal);
 
@@ -108,6 +112,8 @@ void MainWindow::InitUi() {
 
   // Split table
   rightLayout->addWidget(InitSplitTable());
+
+  SRecompute();
 }
 
 void MainWindow::InitMenu() {
@@ -143,15 +149,13 @@ QWidget *MainWindow::InitBillOverview() {
   // Start date
   widgets_.billDateStart = new QDateEdit(QDate::currentDate(), this);
   widgets_.billDateStart->setCalendarPopup(true);
-  connect(widgets_.billDateStart, &QDateEdit::dateChanged, this, &MainWindow::SUpdateBillValidation);
-  connect(widgets_.billDateStart, &QDateEdit::dateChanged, this, &MainWindow::SUpdateSplit);
+  connect(widgets_.billDateStart, &QDateEdit::dateChanged, this, &MainWindow::SScheduleRecompute);
   layout->addRow(tr("Start"), widgets_.billDateStart);
 
   // End date
   widgets_.billDateEnd = new QDateEdit(QDate::currentDate(), this);
   widgets_.billDateEnd->setCalendarPopup(true);
-  connect(widgets_.billDateEnd, &QDateEdit::dateChanged, this, &MainWindow::SUpdateBillValidation);
-  connect(widgets_.billDateEnd, &QDateEdit::dateChanged, this, &MainWindow::SUpdateSplit);
+  connect(widgets_.billDateEnd, &QDateEdit::dateChanged, this, &MainWindow::SScheduleRecompute);
   layout->addRow(tr("End"), widgets_.billDateEnd);
 
   return bill_overview;
@@ -166,9 +170,10 @@ void MainWindow::InitBillLineTable() {
   widgets_.lineView->setModel(bill_line_model_);
   auto *bill_line_delegate = new BillLineDelegate(this);
   widgets_.lineView->setItemDelegate(bill_line_delegate);
-  connect(bill_line_model_, &BillLineModel::rowsInserted, this, &MainWindow::SUpdateSplit);
-  connect(bill_line_model_, &BillLineModel::rowsRemoved, this, &MainWindow::SUpdateSplit);
-  connect(bill_line_model_, &BillLineModel::dataChanged, this, &MainWindow::SUpdateSplit);
+  connect(bill_line_model_, &BillLineModel::rowsInserted, this, &MainWindow::SScheduleRecompute);
+  connect(bill_line_model_, &BillLineModel::rowsRemoved, this, &MainWindow::SScheduleRecompute);
+  connect(bill_line_model_, &BillLineModel::dataChanged, this, &MainWindow::SScheduleRecompute);
+  connect(bill_line_model_, &BillLineModel::modelReset, this, &MainWindow::SScheduleRecompute);
 }
 
 QWidget *MainWindow::InitPeopleTable() {
@@ -187,9 +192,10 @@ QWidget *MainWindow::InitPeopleTable() {
   person_list_model_ = new PersonListModel(people_, this);
   widgets_.peopleView->setModel(person_list_model_);
   people_layout->addWidget(widgets_.peopleView);
-  connect(person_list_model_, &PersonListModel::rowsInserted, this, &MainWindow::SUpdateSplit);
-  connect(person_list_model_, &PersonListModel::rowsRemoved, this, &MainWindow::SUpdateSplit);
-  connect(person_list_model_, &PersonListModel::dataChanged, this, &MainWindow::SUpdateSplit);
+  connect(person_list_model_, &PersonListModel::rowsInserted, this, &MainWindow::SScheduleRecompute);
+  connect(person_list_model_, &PersonListModel::rowsRemoved, this, &MainWindow::SScheduleRecompute);
+  connect(person_list_model_, &PersonListModel::dataChanged, this, &MainWindow::SScheduleRecompute);
+  connect(person_list_model_, &PersonListModel::modelReset, this, &MainWindow::SScheduleRecompute);
 
   // Add/Remove Buttons
   auto *action_buttons = new QDialogButtonBox(this);
@@ -216,7 +222,6 @@ QWidget *MainWindow::InitSplitTable() {
   split_view_model_ = new SplitViewModel(bill_, this);
   widgets_.splitView->setModel(split_view_model_);
   layout->addWidget(widgets_.splitView);
-  SUpdateSplit();
 
   return split_view;
 }
@@ -259,42 +264,54 @@ void MainWindow::SRemovePerson() {
   person_list_model_->RemoveLines(widgets_.peopleView->selectionModel()->selectedIndexes());
 }
 
-void MainWindow::SUpdateLineTotal() {
-  const SplitBill totals = bill_->Total();
-  widgets_.billLineTotalLabel->setText(QLocale().toCurrencyString(totals.GetTotal().GetValue()));
-}
-
 void MainWindow::SUpdateBillTotal(double val) {
   bill_->SetTotalAmount(Money(val, bill_->GetTotalAmount().GetCurrency()));
-  SUpdateBillValidation();
-  SUpdateSplit();
+  SScheduleRecompute();
 }
 
-void MainWindow::SUpdateBillValidation() {
-  static const QSize icon_size = QSize(16, 16);
+void MainWindow::SScheduleRecompute() {
+  if (!recompute_timer_->isActive()) {
+    recompute_timer_->start();
+  }
+}
+
+void MainWindow::SRecompute() {
+  recompute_timer_->stop();
+  const SplitBill totals = bill_->Total();
   ValidationError error;
-  if (!bill_->IsValid(error)) {
+  const bool bill_valid = bill_->IsValid(error);
+  const bool dates_valid = widgets_.billDateStart->date() <= widgets_.billDateEnd->date();
+  UpdateLineTotal(totals);
+  UpdateBillValidation(bill_valid, error, dates_valid);
+  if (bill_valid && dates_valid) {
+    UpdateSplit();
+  }
+}
+
+void MainWindow::UpdateLineTotal(const SplitBill &totals) {
+  widgets_.billLineTotalLabel->setText(QLocale().toCurrencyString(totals.GetTotal().GetValue()));
+}
+
+void MainWindow::UpdateBillValidation(bool bill_valid, ValidationError error, bool dates_valid) {
+  if (!bill_valid) {
     if (error == ValidationError::kLineSumNotTotal) {
       widgets_.billIsValidLabel->setText(tr("The sum of the lines does not equal the total."));
     } else {
       widgets_.billIsValidLabel->setText(tr("The bill is not valid for an unknown reason."));
     }
-    widgets_.billIsValidIcon->setPixmap(QIcon(":/bad").pixmap(icon_size));
-  } else if (widgets_.billDateStart->date() > widgets_.billDateEnd->date()) {
+    widgets_.billIsValidIcon->setPixmap(bad_icon_);
+  } else if (!dates_valid) {
     // The main bill doesn't care about start/end dates
     widgets_.billIsValidLabel->setText(tr("The billing period ends before it starts."));
-    widgets_.billIsValidIcon->setPixmap(QIcon(":/bad").pixmap(icon_size));
+    widgets_.billIsValidIcon->setPixmap(bad_icon_);
   } else {
     widgets_.billIsValidLabel->setText(tr("The bill is valid."));
-    widgets_.billIsValidIcon->setPixmap(QIcon(":/good").pixmap(icon_size));
+    widgets_.billIsValidIcon->setPixmap(good_icon_);
   }
 }
 
-void MainWindow::SUpdateSplit() {
-  ValidationError error;
-  if (bill_->IsValid(error) && widgets_.billDateStart->date() <= widgets_.billDateEnd->date()) {
-    split_view_model_->Update(widgets_.billDateStart->date(), widgets_.billDateEnd->date(), *people_);
-  }
+void MainWindow::UpdateSplit() {
+  split_view_model_->Update(widgets_.billDateStart->date(), widgets_.billDateEnd->date(), *people_);
 }
 
 } // splitbill::ui
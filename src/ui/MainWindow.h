@@ -9,6 +9,8 @@
 #define SPLITBILL_SRC_UI_MAINWINDOW_H_
 
 #include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtGui/QPixmap>
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QTableView>
 #include <QtWidgets/QDoubleSpinBox>
@@ -50,6 +52,10 @@ class MainWindow : public QMainWindow {
   QPointer<PersonListModel> person_list_model_;
   QSharedPointer<QVector<PersonPeriod>> people_;
   QPointer<SplitViewModel> split_view_model_;
+  // Runs one recompute pass once control returns to the event loop
+  QPointer<QTimer> recompute_timer_;
+  QPixmap good_icon_;
+  QPixmap bad_icon_;
 
   void InitUi();
   void InitMenu();
@@ -57,6 +63,9 @@ class MainWindow : public QMainWindow {
   void InitBillLineTable();
   QWidget *InitPeopleTable();
   QWidget *InitSplitTable();
+  void UpdateLineTotal(const SplitBill &totals);
+  void UpdateBillValidation(bool bill_valid, ValidationError error, bool dates_valid);
+  void UpdateSplit();
 
  private Q_SLOTS:
   // Menu actions
@@ -68,10 +77,13 @@ class MainWindow : public QMainWindow {
   void SRemoveBillLine();
   void SAddPerson();
   void SRemovePerson();
-  void SUpdateLineTotal();
   void SUpdateBillTotal(double val);
-  void SUpdateBillValidation();
-  void SUpdateSplit();
+  /**
+   * Mark the totals, validation, and split out of date.  However many times this is called before control returns to
+   * the event loop, they are only recomputed once.
+   */
+  void SScheduleRecompute();
+  void SRecompute();
 };
 
 } // splitbill::ui
@@ -5,9 +5,10 @@
  * @date 6/6/20
  */
 
-#include <QtCore/QSet>
 #include <QtCore/QDate>
+#include <algorithm>
 #include <utility>
+#include <vector>
 #include "PersonListModel.h"
 
 namespace splitbill::ui {
@@ -20,7 +21,7 @@ const std::unordered_map<PersonListModel::Column, QString> PersonListModel::kCol
 
 PersonListModel::PersonListModel(QSharedPointer<QVector<PersonPeriod>> people, QObject *parent) :
     QAbstractTableModel(parent), people_(std::move(people)) {
-
+  display_cache_.Track(this);
 }
 
 int PersonListModel::rowCount(const QModelIndex &parent) const {
@@ -40,18 +41,25 @@ QVariant PersonListModel::data(const QModelIndex &index, int role) const {
   const auto column = static_cast<Column>(index.column());
   const PersonPeriod &person = people_->at(index.row());
   if (role == Qt::ItemDataRole::DisplayRole) {
-    if (column == Column::kName) {
-      return QString::fromStdString(person.GetName());
-    } else if (column == Column::kStart) {
+    const PersonDisplay &display = display_cache_.Get(index.row(), [this, &person]() {
       const QDate start_date(person.GetPeriod().begin().year(),
                              person.GetPeriod().begin().month(),
                              person.GetPeriod().begin().day());
-      return QLocale().toString(start_date, QLocale::ShortFormat);
-    } else if (column == Column::kEnd) {
       const QDate end_date(person.GetPeriod().end().year(),
                            person.GetPeriod().end().month(),
                            person.GetPeriod().end().day());
-      return QLocale().toString(end_date, QLocale::ShortFormat);
+      return PersonDisplay{
+          QString::fromStdString(person.GetName()),
+          locale_.toString(start_date, QLocale::ShortFormat),
+          locale_.toString(end_date, QLocale::ShortFormat),
+      };
+    });
+    if (column == Column::kName) {
+      return display.name;
+    } else if (column == Column::kStart) {
+      return display.start;
+    } else if (column == Column::kEnd) {
+      return display.end;
     }
   } else if (role == Qt::ItemDataRole::EditRole) {
     if (column == Column::kName) {
@@ -122,6 +130,17 @@ void PersonListModel::AddLine(const PersonPeriod &person_period, const QModelInd
   endInsertRows();
 }
 
+void PersonListModel::AddLines(const QVector<PersonPeriod> &person_periods, const QModelIndex &index) {
+  if (person_periods.empty()) {
+    return;
+  }
+  const QModelIndex parent;
+  const int pos = index.isValid() ? index.row() : rowCount(parent);
+  beginInsertRows(parent, pos, pos + person_periods.size() - 1);
+  *people_ = people_->mid(0, pos) + person_periods + people_->mid(pos);
+  endInsertRows();
+}
+
 void PersonListModel::RemoveLine(const size_t &pos) {
   const QModelIndex parent;
   beginRemoveRows(parent, pos, pos);
@@ -136,28 +155,42 @@ void PersonListModel::RemoveLine(const QModelIndex &index) {
 }
 
 void PersonListModel::RemoveLines(const QModelIndexList &indexes) {
-  // Get the rows affected
-  QSet<int> selected_rows;
+  // Get the rows affected, in order
+  std::vector<std::size_t> rows;
   for (const auto &index : indexes) {
     if (index.isValid()) {
-      selected_rows.insert(index.row());
+      rows.push_back(index.row());
     }
   }
-  if (selected_rows.empty()) {
+  if (rows.empty()) {
     return;
   }
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
 
-  QList<int> row_list = selected_rows.values();
-  // Reverse sort the list to remove the last affected row first.  This keeps indexes consistent.
-  std::sort(row_list.begin(), row_list.end(), std::greater<>());
-  const QModelIndex parent;
-  const int first_row = row_list.last();
-  const int last_row = row_list.first();
-  beginRemoveRows(parent, first_row, last_row);
-  for (const auto &row : selected_rows) {
-    people_->remove(row);
+  // A gap in the selection would need a signal per range, so reset the view instead.
+  const bool contiguous = rows.back() - rows.front() + 1 == rows.size();
+  if (contiguous) {
+    beginRemoveRows(QModelIndex(), static_cast<int>(rows.front()), static_cast<int>(rows.back()));
+  } else {
+    beginResetModel();
+  }
+  // Compact the kept people in one pass.
+  int kept = static_cast<int>(rows.front());
+  std::size_t next_removed = 0;
+  for (int row = kept; row < people_->size(); row++) {
+    if (next_removed < rows.size() && rows[next_removed] == static_cast<std::size_t>(row)) {
+      next_removed++;
+      continue;
+    }
+    (*people_)[kept++] = std::move((*people_)[row]);
+  }
+  people_->erase(people_->begin() + kept, people_->end());
+  if (contiguous) {
+    endRemoveRows();
+  } else {
+    endResetModel();
   }
-  endRemoveRows();
 }
 
 } // splitbill::ui
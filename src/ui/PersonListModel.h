@@ -9,10 +9,12 @@
 #define SPLITBILL_SRC_UI_PERSONLISTMODEL_H_
 
 #include <QtCore/QAbstractTableModel>
+#include <QtCore/QLocale>
 #include <QtCore/QSharedPointer>
 #include <unordered_map>
 #include <lib/Bill.h>
 #include "PersonListDelegate.h"
+#include "RowCache.h"
 
 namespace splitbill::ui {
 
@@ -34,6 +36,11 @@ class PersonListModel : public QAbstractTableModel {
   [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
   void AddLine(const PersonPeriod &person_period, const QModelIndex &index);
+
+  /**
+   * Insert <person_periods> before <index>, or at the end, with a single notification.
+   */
+  void AddLines(const QVector<PersonPeriod> &person_periods, const QModelIndex &index);
   void RemoveLine(const size_t &pos);
   void RemoveLine(const QModelIndex &index);
   void RemoveLines(const QModelIndexList &indexes);
@@ -48,6 +55,17 @@ class PersonListModel : public QAbstractTableModel {
   static const unsigned int kColumnCount = static_cast<unsigned int>(Column::kEnd) + 1;
 
   static const std::unordered_map<Column, QString> kColumnNames;
+
+  /**
+   * A person's display strings
+   */
+  struct PersonDisplay {
+    QString name;
+    QString start;
+    QString end;
+  };
+  const QLocale locale_;
+  mutable RowCache<PersonDisplay> display_cache_;
 };
 
 } // splitbill::ui
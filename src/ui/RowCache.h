@@ -0,0 +1,90 @@
+/**
+ * @file RowCache.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_SRC_UI_ROWCACHE_H_
+#define SPLITBILL_SRC_UI_ROWCACHE_H_
+
+#include <QtCore/QAbstractItemModel>
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+namespace splitbill::ui {
+
+/**
+ * Values computed for each row of a model, such as formatted display strings.
+ *
+ * A row's value is made the first time it is asked for and kept until the model reports that row changed, so views
+ * repainting the same rows don't redo the work.
+ *
+ * @tparam Row
+ */
+template<class Row>
+class RowCache {
+ public:
+  explicit RowCache() = default;
+
+  RowCache(const RowCache &) = delete;
+
+  RowCache &operator=(const RowCache &) = delete;
+
+  /**
+   * Follow <model>'s row insertions, removals, changes, and resets.  Call this before any view is attached, so the
+   * cache is up to date before views ask for data.
+   * @param model
+   */
+  void Track(QAbstractItemModel *model) {
+    QObject::connect(model, &QAbstractItemModel::rowsInserted, model,
+                     [this](const QModelIndex &, int first, int last) {
+                       if (static_cast<std::size_t>(first) <= rows_.size()) {
+                         rows_.insert(rows_.begin() + first, last - first + 1, std::nullopt);
+                       }
+                     });
+    QObject::connect(model, &QAbstractItemModel::rowsRemoved, model,
+                     [this](const QModelIndex &, int first, int last) {
+                       if (static_cast<std::size_t>(first) < rows_.size()) {
+                         rows_.erase(rows_.begin() + first,
+                                     rows_.begin() + std::min(static_cast<std::size_t>(last) + 1, rows_.size()));
+                       }
+                     });
+    QObject::connect(model, &QAbstractItemModel::dataChanged, model,
+                     [this](const QModelIndex &top_left, const QModelIndex &bottom_right) {
+                       for (auto row = static_cast<std::size_t>(top_left.row());
+                            row <= static_cast<std::size_t>(bottom_right.row()) && row < rows_.size(); row++) {
+                         rows_[row].reset();
+                       }
+                     });
+    QObject::connect(model, &QAbstractItemModel::modelReset, model, [this]() { rows_.clear(); });
+    QObject::connect(model, &QAbstractItemModel::layoutChanged, model, [this]() { rows_.clear(); });
+  }
+
+  /**
+   * Get the value for <row>, calling <make> to create it if it isn't cached.
+   * @param row
+   * @param make Returns a Row.
+   * @return
+   */
+  template<class Make>
+  const Row &Get(int row, Make make) {
+    if (static_cast<std::size_t>(row) >= rows_.size()) {
+      rows_.resize(row + 1);
+    }
+    std::optional<Row> &value = rows_[row];
+    if (!value) {
+      value.emplace(make());
+    }
+    return *value;
+  }
+
+ private:
+  std::vector<std::optional<Row>> rows_;
+};
+
+} // splitbill::ui
+
+#endif //SPLITBILL_SRC_UI_ROWCACHE_H_
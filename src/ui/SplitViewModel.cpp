@@ -6,11 +6,28 @@
  */
 
 #include "SplitViewModel.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QPromise>
 #include <QtCore/QVector>
 #include <QLocale>
+#include <string>
+#include <unordered_set>
+#include <utility>
 
 namespace splitbill::ui {
 
+SplitViewModel::SplitViewModel(QSharedPointer<Bill> bill, QObject *parent) :
+    QAbstractTableModel(parent), bill_(std::move(bill)), split_state_(std::make_shared<SplitState>()) {
+  display_cache_.Track(this);
+  split_pool_.setMaxThreadCount(1);
+  // The watcher lives in this thread, so results arrive through a queued connection.
+  connect(&split_watcher_, &QFutureWatcherBase::finished, this, &SplitViewModel::SSplitFinished);
+}
+
+SplitViewModel::~SplitViewModel() {
+  split_watcher_.cancel();
+}
+
 const std::unordered_map<SplitViewModel::Column, QString> SplitViewModel::kColumnNames{
     {Column::kName, tr("Name")},
     {Column::kTotal, tr("Total")},
@@ -29,10 +46,16 @@ QVariant SplitViewModel::data(const QModelIndex &index, int role) const {
   const BillPortion &portion = bill_portions_.at(index.row());
 
   if (role == Qt::ItemDataRole::DisplayRole) {
+    const PortionDisplay &display = display_cache_.Get(index.row(), [this, &portion]() {
+      return PortionDisplay{
+          QString::fromStdString(portion.GetName()),
+          locale_.toCurrencyString(portion.GetTotal().GetValue()),
+      };
+    });
     if (column == Column::kName) {
-      return QString::fromStdString(portion.GetName());
+      return display.name;
     } else if (column == Column::kTotal) {
-      return QLocale().toCurrencyString(portion.GetTotal().GetValue());
+      return display.total;
     }
   }
 
@@ -50,30 +73,146 @@ QVariant SplitViewModel::headerData(int section, Qt::Orientation orientation, in
   return {};
 }
 
+void SplitViewModel::RunSplit(QPromise<std::vector<BillPortion>> &promise,
+                              const std::shared_ptr<SplitState> &state,
+                              const SplitBill &bill_totals,
+                              Currency::Code currency,
+                              std::uint64_t bill_version,
+                              const boost::gregorian::date_period &period,
+                              std::vector<PersonPeriod> person_periods,
+                              Roster roster) {
+  if (promise.isCanceled()) {
+    return;
+  }
+  std::optional<IncrementalSplit> &split = state->split;
+  if (split && split->GetPeriod() == period && split->GetRoster().GetNames() == roster.GetNames()
+      && split->GetPersonPeriods().size() == person_periods.size()) {
+    if (state->bill_version != bill_version) {
+      split->SetBill(bill_totals, currency);
+      state->bill_version = bill_version;
+    }
+    // Only the periods that were edited need to be applied.  Each update leaves the split consistent, so stopping
+    // early is safe; the next job picks up where this one stopped.
+    for (std::size_t pos = 0; pos < person_periods.size(); pos++) {
+      if (promise.isCanceled()) {
+        return;
+      }
+      if (split->GetPersonPeriods()[pos] != person_periods[pos]) {
+        split->UpdatePersonPeriod(pos, person_periods[pos]);
+      }
+    }
+  } else {
+    split.emplace(bill_totals, currency, period, std::move(person_periods), std::move(roster));
+    state->bill_version = bill_version;
+  }
+  if (!promise.isCanceled()) {
+    promise.addResult(split->GetPortions());
+  }
+}
+
 void SplitViewModel::Update(const QDate &start, const QDate &end, const QVector<PersonPeriod> &people_periods) {
   if (people_periods.empty()) {
     return;
   }
 
-  QVector<std::string> people;
-  for (const auto &period : people_periods) {
-    if (!people.contains(period.GetName())) {
-      people.append(period.GetName());
+  // The roster holds each name once; periods refer to their person by ID so the split never matches names.
+  Roster roster;
+  std::vector<PersonPeriod> person_periods(people_periods.cbegin(), people_periods.cend());
+  for (auto &person_period : person_periods) {
+    person_period.SetPersonId(roster.Add(person_period.GetName()));
+  }
+
+  const boost::gregorian::date_period period(boost::gregorian::date(start.year(), start.month(), start.day()),
+                                             boost::gregorian::date(end.year(), end.month(), end.day())
+                                                 + boost::gregorian::date_duration(1));
+
+  // Whatever is still running is out of date now.
+  split_watcher_.cancel();
+  split_watcher_.setFuture(QtConcurrent::run(&split_pool_, RunSplit, split_state_, bill_->Total(),
+                                             bill_->GetCurrency().code, bill_->GetVersion(), period,
+                                             std::move(person_periods), std::move(roster)));
+}
+
+void SplitViewModel::SSplitFinished() {
+  // A cancelled job has no result; a newer one is already on its way.
+  if (split_watcher_.isCanceled() || split_watcher_.future().resultCount() == 0) {
+    return;
+  }
+  ApplyPortions(split_watcher_.result());
+}
+
+void SplitViewModel::ApplyPortions(std::vector<BillPortion> new_portions) {
+  const QModelIndex parent;
+  std::unordered_set<std::string> new_names;
+  for (const auto &portion : new_portions) {
+    new_names.insert(portion.GetName());
+  }
+
+  // Remove the people who are gone, last rows first so earlier rows keep their numbers.
+  for (int row = static_cast<int>(bill_portions_.size()) - 1; row >= 0;) {
+    if (new_names.count(bill_portions_[row].GetName()) > 0) {
+      row--;
+      continue;
+    }
+    int first = row;
+    while (first > 0 && new_names.count(bill_portions_[first - 1].GetName()) == 0) {
+      first--;
+    }
+    beginRemoveRows(parent, first, row);
+    bill_portions_.erase(bill_portions_.begin() + first, bill_portions_.begin() + row + 1);
+    endRemoveRows();
+    row = first - 1;
+  }
+
+  // The people who are left must still be in the same order, or there is nothing to gain from matching rows.
+  std::size_t matched = 0;
+  for (const auto &portion : new_portions) {
+    if (matched < bill_portions_.size() && bill_portions_[matched].GetName() == portion.GetName()) {
+      matched++;
     }
   }
+  if (matched != bill_portions_.size()) {
+    beginResetModel();
+    bill_portions_ = std::move(new_portions);
+    endResetModel();
+    return;
+  }
 
-  // Get the new bill portions
-  std::vector new_portions = bill_->Split(
-      start.toString(Qt::DateFormat::ISODate).toStdString(),
-      end.toString(Qt::DateFormat::ISODate).toStdString(),
-      std::vector<PersonPeriod>(people_periods.cbegin(), people_periods.cend()),
-      std::vector<std::string>(people.cbegin(), people.cend())
-  );
+  // Insert the new people between them.
+  for (std::size_t row = 0; row < new_portions.size();) {
+    if (row < bill_portions_.size() && bill_portions_[row].GetName() == new_portions[row].GetName()) {
+      row++;
+      continue;
+    }
+    std::size_t last = row;
+    while (last + 1 < new_portions.size()
+        && (row >= bill_portions_.size() || new_portions[last + 1].GetName() != bill_portions_[row].GetName())) {
+      last++;
+    }
+    beginInsertRows(parent, static_cast<int>(row), static_cast<int>(last));
+    bill_portions_.insert(bill_portions_.begin() + row,
+                          new_portions.begin() + row, new_portions.begin() + last + 1);
+    endInsertRows();
+    row = last + 1;
+  }
 
-  // Update the data representation
-  beginResetModel();
+  // Every row now has the right person; find the totals that changed.
+  std::vector<std::pair<int, int>> changed;
+  for (std::size_t row = 0; row < new_portions.size(); row++) {
+    if (bill_portions_[row].GetTotal() == new_portions[row].GetTotal()) {
+      continue;
+    }
+    if (!changed.empty() && changed.back().second == static_cast<int>(row) - 1) {
+      changed.back().second = static_cast<int>(row);
+    } else {
+      changed.emplace_back(static_cast<int>(row), static_cast<int>(row));
+    }
+  }
   bill_portions_ = std::move(new_portions);
-  endResetModel();
+  const int total_column = static_cast<int>(Column::kTotal);
+  for (const auto &[first, last] : changed) {
+    Q_EMIT(dataChanged(index(first, total_column), index(last, total_column)));
+  }
 }
 
 } // splitbill::ui
@@ -11,27 +11,77 @@
 #include <QtCore/QAbstractTableModel>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QDate>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QLocale>
+#include <QtCore/QPromise>
+#include <QtCore/QThreadPool>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <unordered_map>
 #include <lib/Bill.h>
+#include <lib/IncrementalSplit.h>
+#include "RowCache.h"
 
 namespace splitbill::ui {
 
 class SplitViewModel : public QAbstractTableModel {
  Q_OBJECT
  public:
-  explicit SplitViewModel(QSharedPointer<Bill> bill, QObject *parent) :
-      QAbstractTableModel(parent), bill_(std::move(bill)) {}
+  explicit SplitViewModel(QSharedPointer<Bill> bill, QObject *parent);
+
+  ~SplitViewModel() override;
 
   [[nodiscard]] int rowCount(const QModelIndex &parent) const override;
   [[nodiscard]] int columnCount(const QModelIndex &parent) const override;
   [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
   [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
+  /**
+   * Start splitting the bill in the background.  The model is updated when the split finishes, unless a newer
+   * Update() has replaced it by then.
+   */
   void Update(const QDate &start, const QDate &end, const QVector<PersonPeriod> &people_periods);
 
  private:
+  /**
+   * Split state kept between updates, so editing one person only recomputes the days they changed.  Only the worker
+   * touches it, one job at a time.
+   */
+  struct SplitState {
+    std::optional<IncrementalSplit> split;
+    std::uint64_t bill_version = 0;
+  };
+
   QSharedPointer<Bill> bill_;
   std::vector<BillPortion> bill_portions_;
+  std::shared_ptr<SplitState> split_state_;
+  // A single thread, so jobs run in order and never share the split state
+  QThreadPool split_pool_;
+  QFutureWatcher<std::vector<BillPortion>> split_watcher_;
+
+  /**
+   * Worker side of Update().  Everything it reads is a copy, apart from <state>, which only one job uses at a time.
+   * The split only needs the bill's totals, so those are all that are copied.
+   */
+  static void RunSplit(QPromise<std::vector<BillPortion>> &promise,
+                       const std::shared_ptr<SplitState> &state,
+                       const SplitBill &bill_totals,
+                       Currency::Code currency,
+                       std::uint64_t bill_version,
+                       const boost::gregorian::date_period &period,
+                       std::vector<PersonPeriod> person_periods,
+                       Roster roster);
+
+ private Q_SLOTS:
+  void SSplitFinished();
+
+ private:
+  /**
+   * Replace the portions, matching people by name, so only the rows that changed are announced to views.
+   */
+  void ApplyPortions(std::vector<BillPortion> new_portions);
+
 
   enum class Column {
     kName = 0,
@@ -40,6 +90,16 @@ class SplitViewModel : public QAbstractTableModel {
   static const unsigned int kColumnCount = static_cast<unsigned int>(Column::kTotal) + 1;
 
   static const std::unordered_map<Column, QString> kColumnNames;
+
+  /**
+   * A portion's display strings
+   */
+  struct PortionDisplay {
+    QString name;
+    QString total;
+  };
+  const QLocale locale_;
+  mutable RowCache<PortionDisplay> display_cache_;
 };
 
 } // splitbill::ui
@@ -0,0 +1,25 @@
+/**
+ * @file AllocationCounter.h
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#ifndef SPLITBILL_TESTS_LIB_ALLOCATIONCOUNTER_H_
+#define SPLITBILL_TESTS_LIB_ALLOCATIONCOUNTER_H_
+
+#include <cstddef>
+
+namespace splitbill::test {
+
+/**
+ * Number of times global operator new has been called in this process.
+ *
+ * The test executable replaces operator new to count calls; compare the count before and after the code under test.
+ */
+[[nodiscard]] std::size_t GetAllocationCount();
+
+} // splitbill::test
+
+#endif //SPLITBILL_TESTS_LIB_ALLOCATIONCOUNTER_H_
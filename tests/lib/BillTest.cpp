@@ -6,10 +6,16 @@
  */
 
 #include <gtest/gtest.h>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <lib/Bill.h>
+#include <lib/LineKernels.h>
+#include "AllocationCounter.h"
 
 using namespace splitbill;
 
@@ -94,6 +100,95 @@ TEST_F(BillTest, LinesRemoved) {
   ASSERT_EQ(bill.GetLines().at(1), line_3) << "Bill line at end reordered";
 }
 
+/**
+ * Bulk edits match the same edits made one line at a time
+ */
+TEST_F(BillTest, LinesBulk) {
+  std::vector<BillLine> lines;
+  for (size_t i = 0; i < 150; i++) {
+    BillLine line = i % 2 ? line_split_taxed_ : line_unsplit_untaxed_;
+    line.name = "Line " + std::to_string(i);
+    line.amount = Money(static_cast<double>(i), Currency::Code::USD);
+    lines.push_back(line);
+  }
+  Bill one_by_one = bill_;
+  for (size_t i = 0; i < lines.size(); i++) {
+    one_by_one.AddLine(lines.at(i), 2 + i);
+  }
+  bill_.InsertLines(lines, 2);
+  ASSERT_EQ(bill_.GetLines(), one_by_one.GetLines());
+  EXPECT_EQ(bill_.GetHash(), one_by_one.GetHash());
+  EXPECT_EQ(bill_.Total().GetTotal(), one_by_one.Total().GetTotal());
+
+  const std::vector<size_t> positions{0, 1, 2, 63, 64, 65, 100, 153};
+  for (auto pos = positions.crbegin(); pos != positions.crend(); pos++) {
+    one_by_one.RemoveLine(*pos);
+  }
+  bill_.RemoveLines(positions);
+  ASSERT_EQ(bill_.GetLines(), one_by_one.GetLines());
+  EXPECT_EQ(bill_.GetHash(), one_by_one.GetHash());
+  EXPECT_EQ(bill_.Total().GetTotal(), one_by_one.Total().GetTotal());
+
+  // Bad input leaves the bill alone
+  const std::size_t hash = bill_.GetHash();
+  EXPECT_THROW(bill_.RemoveLines({3, 1}), std::invalid_argument);
+  EXPECT_THROW(bill_.RemoveLines({1, 1}), std::invalid_argument);
+  EXPECT_THROW(bill_.RemoveLines({1, bill_.GetLineCount()}), std::out_of_range);
+  EXPECT_THROW(bill_.InsertLines({lines.front(), BillLine(Currency::Code::EUR)}, 0), std::invalid_argument);
+  EXPECT_THROW(bill_.InsertLines(lines, bill_.GetLineCount() + 1), std::out_of_range);
+  EXPECT_EQ(bill_.GetHash(), hash);
+  EXPECT_EQ(bill_.GetLines(), one_by_one.GetLines());
+}
+
+/**
+ * Edits in a batch end up the same as edits made directly
+ */
+TEST_F(BillTest, Batch) {
+  Bill direct = bill_;
+  std::mt19937 random(5);
+  {
+    Bill::Batch batch(bill_);
+    Bill::Batch nested(bill_);
+    for (unsigned int i = 0; i < 200; i++) {
+      const size_t op = random() % 4;
+      BillLine line = random() % 2 ? line_split_taxed_ : line_unsplit_untaxed_;
+      line.name = "Line " + std::to_string(i);
+      line.tax_rate = (random() % 3) * 0.05;
+      if (op == 0 && direct.GetLineCount() > 0) {
+        const size_t pos = random() % direct.GetLineCount();
+        direct.RemoveLine(pos);
+        bill_.RemoveLine(pos);
+      } else if (op == 1 && direct.GetLineCount() > 0) {
+        const size_t pos = random() % direct.GetLineCount();
+        direct.UpdateLine(pos, line);
+        bill_.UpdateLine(pos, line);
+      } else {
+        const size_t pos = random() % (direct.GetLineCount() + 1);
+        direct.AddLine(line, pos);
+        bill_.AddLine(line, pos);
+      }
+    }
+    EXPECT_TRUE(bill_.IsBatching());
+  }
+  EXPECT_FALSE(bill_.IsBatching());
+  ASSERT_EQ(bill_.GetLines(), direct.GetLines());
+  EXPECT_EQ(bill_.Total().GetTotal(), direct.Total().GetTotal());
+  EXPECT_EQ(bill_.Total().GetTotal(), bill_.TotalLines().GetTotal());
+  EXPECT_EQ(bill_.GetHash(), direct.GetHash());
+  EXPECT_TRUE(bill_.GetChangedLines(direct).empty());
+
+  // Emptying the bill in a batch
+  bill_.BeginBatch();
+  bill_.RemoveLines({0, 1});
+  while (bill_.GetLineCount() > 0) {
+    bill_.RemoveLine(0);
+  }
+  bill_.Commit();
+  EXPECT_EQ(bill_.GetHash(), Bill(Currency::Code::USD).GetHash());
+  EXPECT_EQ(bill_.Total().GetTotal(), Money(0, Currency::Code::USD));
+  EXPECT_THROW(bill_.Commit(), std::logic_error);
+}
+
 /**
  * Lines are updated properly
  */
@@ -120,6 +215,13 @@ TEST_F(BillTest, LinesUpdated) {
   EXPECT_EQ(bill.GetLine(0).amount, 51.00) << "Wrong line updated";
   EXPECT_EQ(bill.GetLine(1).amount, 42.00) << "Line not updated";
   EXPECT_EQ(bill.GetLine(2).amount, 53.00) << "Wrong line updated";
+
+  // Bad updates leave the totals alone
+  const Money total = bill.Total().GetTotal();
+  EXPECT_THROW(bill.UpdateLine(3, line_2), std::out_of_range);
+  EXPECT_THROW(bill.UpdateLine(0, BillLine(Currency::Code::EUR)), std::invalid_argument);
+  EXPECT_EQ(bill.Total().GetTotal(), total);
+  EXPECT_EQ(bill.Total().GetTotal(), bill.TotalLines().GetTotal());
 }
 
 /**
@@ -135,6 +237,384 @@ TEST_F(BillTest, Total) {
   ASSERT_NEAR(totals.GetTotal().GetValue(), 148.83, kResultErrorMargin) << "Total calculated incorrectly";
 }
 
+/**
+ * Totalling does not allocate
+ */
+TEST_F(BillTest, TotalDoesNotAllocate) {
+  for (unsigned int i = 0; i < 1000; i++) {
+    bill_.AddLine(line_split_taxed_);
+  }
+
+  const std::size_t allocations_before = test::GetAllocationCount();
+  const SplitBill totals = bill_.Total();
+  EXPECT_EQ(test::GetAllocationCount(), allocations_before) << "Total allocated memory";
+  EXPECT_NEAR(totals.GetUsageTotal().GetValue(), 84.77 + 1000 * 43.8165, kResultErrorMargin);
+}
+
+/**
+ * Totals follow lines as they are added, updated, and removed
+ */
+TEST_F(BillTest, TotalFollowsEdits) {
+  BillLine line = line_split_untaxed_;
+  line.amount = Money(10.00, Currency::Code::USD);
+  bill_.AddLine(line, 1);
+  EXPECT_NEAR(bill_.Total().GetUsageTotal().GetValue(), 94.77, kResultErrorMargin) << "Added line not totaled";
+
+  line.split = false;
+  line.tax_rate = 0.5;
+  bill_.UpdateLine(1, line);
+  EXPECT_NEAR(bill_.Total().GetUsageTotal().GetValue(), 84.77, kResultErrorMargin) << "Updated line not removed";
+  EXPECT_NEAR(bill_.Total().GetGeneralTotal().GetValue(), 79.07, kResultErrorMargin) << "Updated line not totaled";
+
+  bill_.RemoveLine(1);
+  bill_.RemoveLine(line_split_taxed_);
+  EXPECT_NEAR(bill_.Total().GetUsageTotal().GetValue(), 40.95, kResultErrorMargin) << "Removed line still totaled";
+  EXPECT_NEAR(bill_.Total().GetGeneralTotal().GetValue(), 64.07, kResultErrorMargin) << "Removed line still totaled";
+}
+
+/**
+ * The column store behaves like a vector of lines
+ */
+TEST(BillLineStoreTest, MatchesVector) {
+  BillLineStore store(Currency::Code::USD);
+  std::vector<BillLine> expected;
+  std::mt19937 random(11);
+  const auto make_line = [&random]() {
+    BillLine line(Currency::Code::USD);
+    line.name = "Line " + std::to_string(random() % 1000);
+    line.description = random() % 2 ? "Delivery" : "";
+    line.tax_rate = (random() % 3) * 0.05;
+    line.amount = Money(static_cast<double>(random() % 100000) / 100, Currency::Code::USD);
+    line.split = random() % 2;
+    return line;
+  };
+  const auto expect_same = [&store, &expected]() {
+    ASSERT_EQ(store.GetCount(), expected.size());
+    for (size_t pos = 0; pos < expected.size(); pos++) {
+      ASSERT_EQ(store.Get(pos), expected.at(pos)) << "Line " << pos << " differs";
+      ASSERT_TRUE(store.Equals(pos, expected.at(pos)));
+    }
+    // Unused flag bits stay clear
+    ASSERT_EQ(store.GetSplitBits().size(), (expected.size() + 63) / 64);
+    if (expected.size() % 64 != 0) {
+      ASSERT_EQ(store.GetSplitBits().back() >> (expected.size() % 64), 0);
+    }
+  };
+
+  for (unsigned int i = 0; i < 300; i++) {
+    const size_t pos = random() % (expected.size() + 1);
+    const BillLine line = make_line();
+    store.Insert(pos, line);
+    expected.insert(expected.begin() + pos, line);
+  }
+  expect_same();
+  for (unsigned int i = 0; i < 50; i++) {
+    const size_t pos = random() % expected.size();
+    const BillLine line = make_line();
+    store.Set(pos, line);
+    expected.at(pos) = line;
+    store.Erase(pos / 2);
+    expected.erase(expected.begin() + pos / 2);
+  }
+  expect_same();
+
+  std::vector<size_t> positions;
+  std::vector<BillLine> kept;
+  for (size_t pos = 0; pos < expected.size(); pos++) {
+    if (pos % 3 == 0 || pos > 200) {
+      positions.push_back(pos);
+    } else {
+      kept.push_back(expected.at(pos));
+    }
+  }
+  store.Erase(positions);
+  expected = kept;
+  expect_same();
+
+  EXPECT_THROW(store.Insert(0, BillLine(Currency::Code::EUR)), std::invalid_argument);
+  EXPECT_THROW(store.Erase(expected.size()), std::out_of_range);
+}
+
+TEST(BillLineStoreTest, InternsText) {
+  BillLineStore store(Currency::Code::USD);
+  BillLine line(Currency::Code::USD);
+  line.name = "Electric";
+  line.description = "Monthly service";
+  for (size_t pos = 0; pos < 100; pos++) {
+    store.Insert(pos, line);
+  }
+  EXPECT_EQ(store.GetStrings().GetSize(), 2);
+  EXPECT_EQ(store.GetNameIds().front(), store.GetNameIds().back());
+
+  // A copy has its own pool
+  const BillLineStore copy = store;
+  store.Set(0, BillLine(Currency::Code::USD));
+  EXPECT_EQ(copy.Get(0), line);
+  EXPECT_TRUE(copy.Equals(99, line));
+  EXPECT_EQ(copy.GetStrings().GetSize(), 2);
+
+  BillLine other = line;
+  other.name = "Water";
+  EXPECT_FALSE(store.Equals(1, other));
+  EXPECT_TRUE(store.Equals(1, line));
+
+  // Text is dropped once no line uses it, and its ID goes to the next new text
+  EXPECT_EQ(store.GetStrings().GetSize(), 3);
+  const StringId empty_id = store.GetNameIds().front();
+  store.Erase(0);
+  EXPECT_EQ(store.GetStrings().GetSize(), 2);
+  EXPECT_FALSE(store.GetStrings().Find(""));
+  store.Set(0, other);
+  EXPECT_EQ(store.GetStrings().GetSize(), 3);
+  EXPECT_EQ(store.GetNameIds().front(), empty_id);
+  EXPECT_TRUE(store.Equals(0, other));
+  std::vector<size_t> positions(store.GetCount());
+  std::iota(positions.begin(), positions.end(), 0);
+  store.Erase(positions);
+  EXPECT_EQ(store.GetStrings().GetSize(), 0);
+  store.Insert(0, line);
+  EXPECT_EQ(store.Get(0), line);
+  EXPECT_EQ(store.GetStrings().GetSize(), 2);
+}
+
+/**
+ * Every SIMD level sums lines exactly like the scalar kernel
+ */
+TEST(LineKernelsTest, MatchScalar) {
+  std::mt19937_64 random(5);
+  for (const size_t count : {0, 1, 3, 4, 5, 63, 64, 65, 130, 1001}) {
+    std::vector<FixedDecimal> amounts;
+    std::vector<TaxRate> tax_rates;
+    std::vector<std::uint64_t> split_bits((count + 63) / 64, 0);
+    for (size_t i = 0; i < count; i++) {
+      // Large amounts of either sign fill both halves of each word without overflowing the sums
+      amounts.push_back(FixedDecimal::FromRaw(static_cast<std::int64_t>(random()) >> 12));
+      tax_rates.push_back(TaxRate::FromMillionths(static_cast<std::int64_t>(random() % 3) * 50000));
+      if (random() % 2) {
+        split_bits.at(i / 64) |= std::uint64_t(1) << (i % 64);
+      }
+    }
+    // Five rates take two passes, and one of them matches nothing
+    const std::vector<TaxRate> rates{TaxRate::FromMillionths(50000), TaxRate::FromMillionths(0),
+                                     TaxRate::FromMillionths(100000), TaxRate::FromMillionths(1),
+                                     TaxRate::FromMillionths(0)};
+    std::vector<LineSums> expected(rates.size());
+    SumLinesByTaxRate(amounts.data(), tax_rates.data(), split_bits.data(), count, rates.data(), expected.data(),
+                      rates.size(), SimdLevel::kScalar);
+    for (int level = 0; level <= static_cast<int>(GetSimdLevel()); level++) {
+      for (size_t rate_count = 0; rate_count <= rates.size(); rate_count++) {
+        std::vector<LineSums> sums(rate_count);
+        SumLinesByTaxRate(amounts.data(), tax_rates.data(), split_bits.data(), count, rates.data(), sums.data(),
+                          rate_count, static_cast<SimdLevel>(level));
+        for (size_t rate = 0; rate < rate_count; rate++) {
+          EXPECT_EQ(sums.at(rate).usage, expected.at(rate).usage) << "Level " << level << ", " << count << " lines";
+          EXPECT_EQ(sums.at(rate).general, expected.at(rate).general) << "Level " << level << ", " << count << " lines";
+          EXPECT_EQ(sums.at(rate).line_count, expected.at(rate).line_count)
+                    << "Level " << level << ", " << count << " lines";
+        }
+      }
+    }
+  }
+  // The scalar kernel agrees with counting each line
+  std::vector<FixedDecimal> amounts{FixedDecimal(1), FixedDecimal(2), FixedDecimal(4), FixedDecimal(8)};
+  std::vector<TaxRate> tax_rates{TaxRate(0.05), TaxRate(0), TaxRate(0.05), TaxRate(0.05)};
+  std::vector<std::uint64_t> split_bits{0b1001};
+  const TaxRate rate(0.05);
+  LineSums sums;
+  SumLinesByTaxRate(amounts.data(), tax_rates.data(), split_bits.data(), 4, &rate, &sums, 1, SimdLevel::kScalar);
+  EXPECT_EQ(sums.usage, FixedDecimal(9).GetRaw());
+  EXPECT_EQ(sums.general, FixedDecimal(4).GetRaw());
+  EXPECT_EQ(sums.line_count, 3);
+}
+
+/**
+ * Sums that don't fit throw on every level instead of wrapping
+ */
+TEST(LineKernelsTest, Overflow) {
+  const FixedDecimal big = FixedDecimal::FromRaw(std::numeric_limits<std::int64_t>::max() / 2 + 1);
+  const TaxRate rate(0);
+  for (const size_t count : {2, 3, 9, 600}) {
+    std::vector<FixedDecimal> amounts(count, FixedDecimal(0));
+    amounts.at(0) = big;
+    amounts.at(count - 1) = big;
+    const std::vector<TaxRate> tax_rates(count, rate);
+    const std::vector<std::uint64_t> split_bits((count + 63) / 64, ~std::uint64_t(0));
+    for (int level = 0; level <= static_cast<int>(GetSimdLevel()); level++) {
+      LineSums sums;
+      EXPECT_THROW(SumLinesByTaxRate(amounts.data(), tax_rates.data(), split_bits.data(), count, &rate, &sums, 1,
+                                     static_cast<SimdLevel>(level)), std::overflow_error)
+                << "Level " << level << ", " << count << " lines";
+      // Negative amounts bring it back into range
+      std::vector<FixedDecimal> balanced(amounts);
+      balanced.at(count / 2) = FixedDecimal::FromRaw(-big.GetRaw());
+      SumLinesByTaxRate(balanced.data(), tax_rates.data(), split_bits.data(), count, &rate, &sums, 1,
+                        static_cast<SimdLevel>(level));
+      EXPECT_EQ(sums.usage, count == 2 ? 0 : big.GetRaw()) << "Level " << level;
+    }
+  }
+}
+
+/**
+ * Totalling from the lines matches the running totals
+ */
+TEST_F(BillTest, TotalLines) {
+  for (unsigned int i = 0; i < 1000; i++) {
+    BillLine line(Currency::Code::USD);
+    line.amount = Money(0.01 * i, Currency::Code::USD);
+    line.tax_rate = (i % 4) * 0.0125;
+    line.split = i % 3 != 0;
+    bill_.AddLine(line);
+  }
+  for (size_t pos = 0; pos < bill_.GetLineCount(); pos += 7) {
+    bill_.RemoveLine(pos);
+  }
+  const SplitBill totals = bill_.Total();
+  const SplitBill line_totals = bill_.TotalLines();
+  EXPECT_DOUBLE_EQ(line_totals.GetUsageTotal().GetValue(), totals.GetUsageTotal().GetValue());
+  EXPECT_DOUBLE_EQ(line_totals.GetGeneralTotal().GetValue(), totals.GetGeneralTotal().GetValue());
+#ifndef SPLITBILL_MONEY_DECIMAL
+  EXPECT_TRUE(line_totals.GetUsageTotal() == totals.GetUsageTotal());
+  EXPECT_TRUE(line_totals.GetGeneralTotal() == totals.GetGeneralTotal());
+#endif
+}
+
+/**
+ * Tax rates are stored exactly
+ */
+TEST(TaxRateTest, Exact) {
+  EXPECT_EQ(TaxRate(0.07).GetMillionths(), 70000);
+  EXPECT_EQ(TaxRate(0.08875).GetMillionths(), 88750);
+  EXPECT_TRUE(TaxRate(0.1 + 0.2) == TaxRate(0.3));
+  EXPECT_DOUBLE_EQ(TaxRate::FromMillionths(12345).ToDouble(), 0.012345);
+  EXPECT_DOUBLE_EQ(TaxRate(0.07).Apply(Money(40.95, Currency::Code::USD)).GetValue(), 43.82);
+  // 1.070001 has no exact double, but the tax on $100 is exactly $7.0001
+  EXPECT_EQ(TaxRate::FromMillionths(70001).Apply(Money(100, Currency::Code::USD)),
+            Money::FromDecimal(Money::Decimal(1070001) / Money::Decimal(10000), Currency::Code::USD));
+}
+
+/**
+ * Totals taxed per rate match taxing every line
+ */
+TEST_F(BillTest, TotalByTaxRate) {
+  const std::vector<double> rates{0, 0.07, 0.08875};
+  Money usage = bill_.Total().GetUsageTotal();
+  Money general = bill_.Total().GetGeneralTotal();
+  for (unsigned int i = 0; i < 300; i++) {
+    BillLine line(Currency::Code::USD);
+    line.amount = Money(1.23 + i, Currency::Code::USD);
+    line.tax_rate = rates.at(i % rates.size());
+    line.split = i % 2 == 0;
+    bill_.AddLine(line);
+    if (line.split) {
+      usage = usage + line.GetTaxedAmount();
+    } else {
+      general = general + line.GetTaxedAmount();
+    }
+  }
+  EXPECT_NEAR(bill_.Total().GetUsageTotal().GetValue(), usage.GetValue(), kResultErrorMargin);
+  EXPECT_NEAR(bill_.Total().GetGeneralTotal().GetValue(), general.GetValue(), kResultErrorMargin);
+
+  while (bill_.GetLineCount() > 0) {
+    bill_.RemoveLine(0);
+  }
+  EXPECT_TRUE(bill_.Total().GetUsageTotal() == 0);
+  EXPECT_TRUE(bill_.Total().GetGeneralTotal() == 0);
+}
+
+/**
+ * The version changes whenever the bill does
+ */
+TEST_F(BillTest, Version) {
+  std::uint64_t version = bill_.GetVersion();
+  const auto expect_changed = [this, &version](const char *what) {
+    EXPECT_NE(bill_.GetVersion(), version) << what << " did not change the version";
+    version = bill_.GetVersion();
+  };
+
+  (void) bill_.Total();
+  EXPECT_EQ(bill_.GetVersion(), version) << "Reading the bill changed the version";
+  bill_.AddLine(line_split_taxed_);
+  expect_changed("AddLine");
+  bill_.UpdateLine(0, line_split_taxed_);
+  expect_changed("UpdateLine");
+  bill_.RemoveLine(0);
+  expect_changed("RemoveLine");
+  BillLine missing_line = line_split_taxed_;
+  missing_line.amount = Money(123.45, Currency::Code::USD);
+  bill_.RemoveLine(missing_line);
+  EXPECT_EQ(bill_.GetVersion(), version) << "Removing a line that isn't there changed the version";
+  bill_.SetTotalAmount(Money(1.00, Currency::Code::USD));
+  expect_changed("SetTotalAmount");
+}
+
+/**
+ * Hashes follow the bill's contents, however it was built
+ */
+TEST_F(BillTest, Hash) {
+  const auto rebuild = [](const Bill &bill) {
+    Bill copy(bill.GetCurrency());
+    copy.SetTotalAmount(bill.GetTotalAmount());
+    for (const auto &line : bill.GetLines()) {
+      copy.AddLine(line);
+    }
+    return copy;
+  };
+
+  // Edit every position so all the tree's branches change shape
+  for (size_t pos = 0; pos < 40; pos++) {
+    BillLine line = line_split_taxed_;
+    line.name = "Line " + std::to_string(pos);
+    bill_.AddLine(line, pos % (bill_.GetLineCount() + 1));
+    EXPECT_EQ(bill_.GetHash(), rebuild(bill_).GetHash()) << "Hash differs after inserting at " << pos;
+  }
+  for (size_t pos = 0; pos < bill_.GetLineCount(); pos += 3) {
+    BillLine line = bill_.GetLine(pos);
+    line.amount = line.amount + 1;
+    bill_.UpdateLine(pos, line);
+    EXPECT_EQ(bill_.GetHash(), rebuild(bill_).GetHash()) << "Hash differs after updating " << pos;
+  }
+  while (bill_.GetLineCount() > 0) {
+    bill_.RemoveLine(bill_.GetLineCount() / 2);
+    EXPECT_EQ(bill_.GetHash(), rebuild(bill_).GetHash()) << "Hash differs with " << bill_.GetLineCount() << " lines";
+  }
+  EXPECT_EQ(bill_.GetHash(), Bill(Currency::Code::USD).GetHash());
+  bill_.SetTotalAmount(Money(1.00, Currency::Code::USD));
+  EXPECT_NE(bill_.GetHash(), Bill(Currency::Code::USD).GetHash());
+
+  EXPECT_EQ(line_split_taxed_.GetHash(), BillLine(line_split_taxed_).GetHash());
+  EXPECT_NE(line_split_taxed_.GetHash(), line_split_untaxed_.GetHash());
+  const PersonPeriod person_period("Person", "2020-01-01", "2020-01-31");
+  EXPECT_EQ(person_period.GetHash(), PersonPeriod("Person", "2020-01-01", "2020-01-31").GetHash());
+  EXPECT_NE(person_period.GetHash(), PersonPeriod("Person", "2020-01-01", "2020-01-30").GetHash());
+}
+
+/**
+ * Changed lines are found by comparing hashes
+ */
+TEST_F(BillTest, ChangedLines) {
+  for (size_t pos = 0; pos < 100; pos++) {
+    BillLine line = line_split_untaxed_;
+    line.name = "Line " + std::to_string(pos);
+    bill_.AddLine(line);
+  }
+  Bill edited = bill_;
+  EXPECT_TRUE(edited.GetChangedLines(bill_).empty());
+
+  const std::vector<size_t> changes{0, 17, 18, 63, 103};
+  for (const size_t pos : changes) {
+    BillLine line = edited.GetLine(pos);
+    line.description = "Changed";
+    edited.UpdateLine(pos, line);
+    EXPECT_NE(edited.GetLineHash(pos), bill_.GetLineHash(pos));
+  }
+  EXPECT_EQ(edited.GetChangedLines(bill_), changes);
+  EXPECT_EQ(bill_.GetChangedLines(edited), changes);
+
+  // Lines past the end of the shorter bill count as changed
+  edited.RemoveLine(edited.GetLineCount() - 1);
+  EXPECT_EQ(edited.GetChangedLines(bill_), changes);
+}
+
 /**
  * Bill split properly
  */
@@ -0,0 +1,109 @@
+/**
+ * @file MoneyTest.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <lib/FixedDecimal.h>
+#include <lib/Money.h>
+
+using namespace splitbill;
+
+/**
+ * Values are rounded to the currency's minor unit
+ */
+TEST(MoneyTest, GetValueRounds) {
+  EXPECT_DOUBLE_EQ(Money(30.954, Currency::Code::USD).GetValue(), 30.95);
+  EXPECT_DOUBLE_EQ(Money(30.955, Currency::Code::USD).GetValue(), 30.96);
+  EXPECT_DOUBLE_EQ(Money(-30.955, Currency::Code::USD).GetValue(), -30.96);
+  EXPECT_DOUBLE_EQ(Money(30.5, Currency::Code::JPY).GetValue(), 31);
+}
+
+/**
+ * Arithmetic keeps precision finer than the minor unit
+ */
+TEST(MoneyTest, Arithmetic) {
+  const Money a(40.95, Currency::Code::USD);
+  const Money b(30.95, Currency::Code::USD);
+
+  EXPECT_DOUBLE_EQ((a + b).GetValue(), 71.90);
+  EXPECT_DOUBLE_EQ((a - b).GetValue(), 10.00);
+  EXPECT_DOUBLE_EQ((a * 1.07).GetValue(), 43.82);
+  EXPECT_DOUBLE_EQ((a / 31).GetValue(), 1.32);
+  // 1/3 of a cent per part must survive being added back up
+  const Money third = Money(0.01, Currency::Code::USD) / 3;
+  EXPECT_DOUBLE_EQ((third * 3).GetValue(), 0.01);
+  EXPECT_DOUBLE_EQ((third + third + third).GetValue(), 0.01);
+  // Scaling multiplies before dividing, without overflowing in between
+  EXPECT_EQ(Money(1000, Currency::Code::USD).Scale(31'536'000, 31'536'000), Money(1000, Currency::Code::USD));
+  EXPECT_DOUBLE_EQ(Money(1000, Currency::Code::USD).Scale(1, 3).GetValue(), 333.33);
+  EXPECT_THROW((void) a.Scale(1, 0), std::domain_error);
+}
+
+/**
+ * Comparisons
+ */
+TEST(MoneyTest, Compare) {
+  const Money a(40.95, Currency::Code::USD);
+  const Money b(30.95, Currency::Code::USD);
+
+  EXPECT_TRUE(a > b);
+  EXPECT_TRUE(b < a);
+  EXPECT_TRUE(a == Money(40.95, Currency::Code::USD));
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a == 40.95);
+  EXPECT_TRUE(a > 40);
+}
+
+/**
+ * Mixing currencies is an error
+ */
+TEST(MoneyTest, CurrencyMismatch) {
+  const Money usd(1, Currency::Code::USD);
+  const Money eur(1, Currency::Code::EUR);
+
+  EXPECT_FALSE(usd == eur);
+  EXPECT_THROW((void) (usd + eur), std::invalid_argument);
+  EXPECT_THROW((void) (usd < eur), std::invalid_argument);
+}
+
+/**
+ * Currencies can be found by code at compile time or run time
+ */
+TEST(MoneyTest, CurrencyLookup) {
+  static_assert(Currency::Get(Currency::Code::USD).multiplier() == 100);
+  static_assert(Currency::Get("JPY").multiplier() == 1);
+
+  EXPECT_EQ(Currency::Get(std::string("USD")).code, Currency::Code::USD);
+  EXPECT_EQ(Currency::Get("EUR").iso_4217_code, "EUR");
+  EXPECT_DOUBLE_EQ(Currency::Get("USD").error_margin(), 0.001);
+  EXPECT_THROW((void) Currency::Get("XXX"), std::out_of_range);
+  EXPECT_THROW((void) Currency::Get("US"), std::out_of_range);
+}
+
+/**
+ * Fixed-point results outside the representable range throw instead of wrapping
+ */
+TEST(FixedDecimalTest, Overflow) {
+  const FixedDecimal max = FixedDecimal::FromRaw(std::numeric_limits<std::int64_t>::max());
+  const FixedDecimal min = FixedDecimal::FromRaw(std::numeric_limits<std::int64_t>::min());
+
+  EXPECT_THROW((void) (max + FixedDecimal::FromRaw(1)), std::overflow_error);
+  EXPECT_THROW((void) (min - FixedDecimal::FromRaw(1)), std::overflow_error);
+  EXPECT_THROW((void) (FixedDecimal(5'000'000'000.0) * FixedDecimal(2)), std::overflow_error);
+  EXPECT_THROW((void) (FixedDecimal(5'000'000'000.0) / FixedDecimal(0.5)), std::overflow_error);
+  EXPECT_THROW((void) FixedDecimal(1e10), std::overflow_error);
+  EXPECT_THROW((void) FixedDecimal(std::nan("")), std::overflow_error);
+
+  // The edges of the range still work
+  EXPECT_EQ((max - FixedDecimal::FromRaw(1) + FixedDecimal::FromRaw(1)), max);
+  EXPECT_EQ((min + FixedDecimal::FromRaw(1) - FixedDecimal::FromRaw(1)), min);
+  EXPECT_EQ(FixedDecimal(-9'000'000'000.0).GetRaw(), -9'000'000'000'000'000'000);
+}
@@ -0,0 +1,537 @@
+/**
+ * @file SplitTest.cpp
+ *
+ * @author dankeenan
+ * @date 10/17/26
+ * @copyright (c) 2026 Dan Keenan
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <lib/Bill.h>
+#include <lib/IncrementalSplit.h>
+#include <lib/Occupancy.h>
+#include <lib/PresenceCalendar.h>
+#include <lib/SplitCache.h>
+
+using namespace splitbill;
+
+namespace {
+
+/**
+ * The original day-by-day split, kept as a reference for the faster engines.
+ */
+std::vector<BillPortion> ReferenceSplit(const Bill &bill,
+                                        const boost::gregorian::date_period &period,
+                                        const std::vector<PersonPeriod> &person_periods,
+                                        const std::vector<std::string> &people) {
+  const SplitBill totals = bill.Total();
+  const Money usage_part = totals.GetUsageTotal() / period.length().days();
+
+  std::map<boost::gregorian::date, unsigned int> day_parts;
+  unsigned int everyone_usage_days = 0;
+  for (boost::gregorian::day_iterator day(period.begin()); *day < period.end(); ++day) {
+    unsigned int day_part_count = 0;
+    for (const auto &person_period : person_periods) {
+      if (person_period.GetPeriod().contains(*day)) {
+        day_part_count++;
+      }
+    }
+    if (day_part_count == 0) {
+      day_part_count = people.size();
+      everyone_usage_days++;
+    }
+    day_parts.insert({*day, day_part_count});
+  }
+  const Money everyone_usage = (usage_part / people.size()) * everyone_usage_days;
+
+  const Money general_chunk = totals.GetGeneralTotal() / people.size();
+  std::vector<BillPortion> portions;
+  for (const auto &person : people) {
+    Money person_usage = everyone_usage;
+    for (const auto &person_period : person_periods) {
+      if (person_period.GetName() != person) {
+        continue;
+      }
+      for (boost::gregorian::day_iterator day(period.begin()); *day < period.end(); ++day) {
+        if (person_period.GetPeriod().contains(*day)) {
+          person_usage = person_usage + usage_part / day_parts.at(*day);
+        }
+      }
+    }
+    portions.emplace_back(person, person_usage, general_chunk);
+  }
+
+  return portions;
+}
+
+} // namespace
+
+class SplitTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    BillLine usage_line(Currency::Code::USD);
+    usage_line.amount = Money(1234.56, Currency::Code::USD);
+    usage_line.tax_rate = 0.07;
+    bill_.AddLine(usage_line);
+    BillLine general_line(Currency::Code::USD);
+    general_line.amount = Money(78.90, Currency::Code::USD);
+    general_line.split = false;
+    bill_.AddLine(general_line);
+  }
+
+  /**
+   * Create a random roster whose periods start and end anywhere from a month before to a month after <period>.
+   */
+  void MakeRoster(const boost::gregorian::date_period &period, unsigned int people_count, unsigned int period_count) {
+    std::mt19937 random(people_count * 7919 + period_count);
+    const long span = period.length().days() + 60;
+    std::uniform_int_distribution<long> offset_distribution(0, span);
+    std::uniform_int_distribution<unsigned int> person_distribution(0, people_count - 1);
+
+    people_.clear();
+    person_periods_.clear();
+    for (unsigned int person = 0; person < people_count; person++) {
+      people_.push_back("Person " + std::to_string(person));
+    }
+    const boost::gregorian::date origin = period.begin() - boost::gregorian::date_duration(30);
+    for (unsigned int i = 0; i < period_count; i++) {
+      long start = offset_distribution(random);
+      long end = offset_distribution(random);
+      if (end < start) {
+        std::swap(start, end);
+      }
+      person_periods_.emplace_back(people_.at(person_distribution(random)),
+                                   boost::gregorian::date_period(origin + boost::gregorian::date_duration(start),
+                                                                 origin + boost::gregorian::date_duration(end + 1)));
+    }
+  }
+
+  static void ExpectSamePortions(const std::vector<BillPortion> &actual, const std::vector<BillPortion> &expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < actual.size(); i++) {
+      EXPECT_EQ(actual.at(i).GetName(), expected.at(i).GetName());
+      EXPECT_DOUBLE_EQ(actual.at(i).GetUsageTotal().GetValue(), expected.at(i).GetUsageTotal().GetValue())
+                << "Usage differs for " << expected.at(i).GetName();
+      EXPECT_DOUBLE_EQ(actual.at(i).GetGeneralTotal().GetValue(), expected.at(i).GetGeneralTotal().GetValue())
+                << "General differs for " << expected.at(i).GetName();
+    }
+  }
+
+  /**
+   * Portions are equal to the last digit, not just after rounding to the minor unit.
+   */
+  static void ExpectExactPortions(const std::vector<BillPortion> &actual, const std::vector<BillPortion> &expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < actual.size(); i++) {
+      EXPECT_EQ(actual.at(i).GetName(), expected.at(i).GetName());
+      EXPECT_TRUE(actual.at(i).GetUsageTotal() == expected.at(i).GetUsageTotal())
+                << "Usage differs for " << expected.at(i).GetName();
+      EXPECT_TRUE(actual.at(i).GetGeneralTotal() == expected.at(i).GetGeneralTotal())
+                << "General differs for " << expected.at(i).GetName();
+    }
+  }
+
+  Bill bill_ = Bill(Currency::Code::USD);
+  std::vector<std::string> people_;
+  std::vector<PersonPeriod> person_periods_;
+};
+
+/**
+ * Split matches the day-by-day reference for random rosters
+ */
+TEST_F(SplitTest, MatchesReference) {
+  const boost::gregorian::date_period period(boost::gregorian::date(2020, 1, 1), boost::gregorian::date(2020, 4, 1));
+  for (const auto &[people_count, period_count] : std::vector<std::pair<unsigned int, unsigned int>>{
+      {1, 0}, {1, 1}, {3, 2}, {5, 20}, {40, 100}}) {
+    MakeRoster(period, people_count, period_count);
+    const std::vector<BillPortion> expected = ReferenceSplit(bill_, period, person_periods_, people_);
+    ExpectSamePortions(bill_.Split(period, person_periods_, people_, {SplitMode::kDaily}), expected);
+    ExpectSamePortions(bill_.Split(period, person_periods_, people_, {SplitMode::kInterval}), expected);
+    ExpectSamePortions(bill_.Split(period, person_periods_, people_, {SplitMode::kPresenceCalendar}), expected);
+  }
+}
+
+/**
+ * Interval splits of long periods only depend on the number of presence periods
+ */
+TEST_F(SplitTest, IntervalLongPeriod) {
+  const boost::gregorian::date_period period(boost::gregorian::date(1990, 1, 1), boost::gregorian::date(2030, 1, 1));
+  MakeRoster(period, 10, 30);
+  ExpectSamePortions(bill_.Split(period, person_periods_, people_, {SplitMode::kInterval}),
+                     bill_.Split(period, person_periods_, people_, {SplitMode::kDaily}));
+}
+
+/**
+ * Splitting across threads gives exactly the same results as splitting on one
+ */
+TEST_F(SplitTest, ParallelMatchesSerial) {
+  const boost::gregorian::date_period period(boost::gregorian::date(2015, 1, 1), boost::gregorian::date(2020, 1, 1));
+  MakeRoster(period, 300, 2000);
+  for (const SplitMode mode : {SplitMode::kDaily, SplitMode::kInterval}) {
+    const std::vector<BillPortion> serial = bill_.Split(period, person_periods_, people_, {mode, 1});
+    for (const unsigned int threads : {2u, 7u, 0u}) {
+      const std::vector<BillPortion> parallel = bill_.Split(period, person_periods_, people_, {mode, threads});
+      ASSERT_EQ(parallel.size(), serial.size());
+      for (std::size_t i = 0; i < serial.size(); i++) {
+        EXPECT_EQ(parallel.at(i).GetUsageTotal(), serial.at(i).GetUsageTotal())
+                  << "Usage differs for " << serial.at(i).GetName() << " with " << threads << " threads";
+      }
+    }
+  }
+}
+
+/**
+ * Splitting bills together gives the same results as splitting them one at a time
+ */
+TEST_F(SplitTest, SplitAll) {
+  const boost::gregorian::date_period period(boost::gregorian::date(2020, 1, 1), boost::gregorian::date(2021, 1, 1));
+  MakeRoster(period, 25, 80);
+  const Roster roster(people_);
+
+  std::vector<Bill> bills{bill_};
+  for (const auto &[amount, currency] : std::vector<std::pair<double, Currency::Code>>{
+      {55.55, Currency::Code::USD}, {0, Currency::Code::USD}, {987.65, Currency::Code::EUR}}) {
+    Bill bill(currency);
+    BillLine line(currency);
+    line.amount = Money(amount, currency);
+    bill.AddLine(line);
+    bills.push_back(bill);
+  }
+
+  for (const SplitMode mode : {SplitMode::kDaily, SplitMode::kInterval}) {
+    const std::vector<std::vector<BillPortion>> all_portions =
+        Bill::SplitAll(bills, period, person_periods_, roster, {mode, 3});
+    ASSERT_EQ(all_portions.size(), bills.size());
+    for (std::size_t bill = 0; bill < bills.size(); bill++) {
+      const std::vector<BillPortion> expected = bills.at(bill).Split(period, person_periods_, roster, {mode});
+      ASSERT_EQ(all_portions.at(bill).size(), expected.size());
+      for (std::size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(all_portions.at(bill).at(i).GetUsageTotal(), expected.at(i).GetUsageTotal());
+        EXPECT_EQ(all_portions.at(bill).at(i).GetGeneralTotal(), expected.at(i).GetGeneralTotal());
+      }
+    }
+  }
+}
+
+/**
+ * Periods for people who are not being billed still take up a share of the days they are present
+ */
+TEST_F(SplitTest, UnknownPeopleTakeShare) {
+  const boost::gregorian::date_period period(boost::gregorian::date(2020, 1, 1), boost::gregorian::date(2020, 2, 1));
+  MakeRoster(period, 4, 12);
+  people_.pop_back();
+  ExpectSamePortions(bill_.Split(period, person_periods_, people_),
+                     ReferenceSplit(bill_, period, person_periods_, people_));
+}
+
+/**
+ * Interval occupancy only cuts the period where occupancy changes
+ */
+TEST(IntervalOccupancyTest, Segments) {
+  const IntervalOccupancy occupancy(100, {{10, 20}, {15, 30}, {50, 50}, {90, 100}});
+
+  ASSERT_EQ(occupancy.GetSegmentCount(), 6);
+  const std::vector<std::pair<std::int64_t, unsigned int>> expected{
+      {10, 0}, {5, 1}, {5, 2}, {10, 1}, {60, 0}, {10, 1}};
+  for (std::size_t segment = 0; segment < expected.size(); segment++) {
+    EXPECT_EQ(occupancy.GetSegmentLength(segment), expected.at(segment).first);
+    EXPECT_EQ(occupancy.GetOccupancy(segment), expected.at(segment).second);
+  }
+  EXPECT_EQ(occupancy.GetEmptyLength(), 70);
+  EXPECT_EQ(occupancy.GetSegments({15, 30}), (std::pair<std::size_t, std::size_t>(2, 4)));
+}
+
+/**
+ * The presence calendar counts the same occupancy as the difference array
+ */
+TEST_F(SplitTest, PresenceCalendarOccupancy) {
+  const boost::gregorian::date_period period(boost::gregorian::date(2020, 1, 1), boost::gregorian::date(2020, 12, 17));
+  MakeRoster(period, 50, 300);
+  const DayOccupancy occupancy(period, person_periods_);
+  const PresenceCalendar calendar(period, person_periods_);
+
+  ASSERT_EQ(calendar.GetDayCount(), occupancy.GetSegmentCount());
+  EXPECT_EQ(calendar.GetEmptyLength(), occupancy.GetEmptyLength());
+  for (std::size_t day = 0; day < occupancy.GetSegmentCount(); day++) {
+    EXPECT_EQ(calendar.GetOccupancy(day), occupancy.GetOccupancy(day)) << "Occupancy differs on day " << day;
+  }
+  ASSERT_EQ(calendar.GetRowCount(), person_periods_.size());
+  for (std::size_t row = 0; row < person_periods_.size(); row++) {
+    const auto [first, last] = GetDayOffsets(period, person_periods_.at(row).GetPeriod());
+    for (std::int64_t day = 0; day < static_cast<std::int64_t>(calendar.GetDayCount()); day++) {
+      EXPECT_EQ(calendar.IsPresent(row, day), day >= first && day < last)
+                << "Row " << row << " presence differs on day " << day;
+    }
+  }
+
+  // Shares summed from the bitsets match the ones summed from running totals, across several words of rows
+  ExpectSamePortions(bill_.Split(period, person_periods_, people_, {SplitMode::kPresenceCalendar, 4}),
+                     bill_.Split(period, person_periods_, people_, {SplitMode::kDaily, 1}));
+}
+
+/**
+ * Roster IDs are dense and names are only added once
+ */
+TEST(RosterTest, Intern) {
+  Roster roster({"Alice", "Bob", "Alice"});
+  ASSERT_EQ(roster.GetPersonCount(), 2);
+  EXPECT_EQ(roster.Add("Carol"), 2);
+  EXPECT_EQ(roster.Add("Bob"), 1);
+  EXPECT_EQ(roster.Find("Alice"), std::optional<PersonId>(0));
+  EXPECT_EQ(roster.Find("Dave"), std::nullopt);
+  EXPECT_EQ(roster.GetName(2), "Carol");
+}
+
+/**
+ * Periods can refer to people by roster ID instead of name
+ */
+TEST_F(SplitTest, RosterIds) {
+  const boost::gregorian::date_period period(boost::gregorian::date(2020, 1, 1), boost::gregorian::date(2020, 2, 1));
+  MakeRoster(period, 6, 20);
+  const Roster roster(people_);
+  const std::vector<BillPortion> by_name = bill_.Split(period, person_periods_, roster);
+
+  for (auto &person_period : person_periods_) {
+    const PersonId person_id = *roster.Find(person_period.GetName());
+    person_period.SetName("Renamed");
+    EXPECT_EQ(person_period.GetPersonId(), kNoPersonId) << "Renaming kept the old ID";
+    // Once the ID is set, the name is no longer consulted
+    person_period.SetPersonId(person_id);
+  }
+  const std::vector<BillPortion> by_id = bill_.Split(period, person_periods_, roster);
+  ExpectSamePortions(by_id, by_name);
+  for (PersonId person_id = 0; person_id < by_id.size(); person_id++) {
+    EXPECT_EQ(by_id.at(person_id).GetPersonId(), person_id);
+  }
+}
+
+/**
+ * Editing periods one at a time gives the same portions as splitting again, exactly the same as a daily split
+ */
+TEST_F(SplitTest, IncrementalSplit) {
+  const boost::gregorian::date_period period(boost::gregorian::date(2020, 1, 1), boost::gregorian::date(2020, 3, 1));
+  MakeRoster(period, 8, 30);
+  const Roster roster(people_);
+  IncrementalSplit split(bill_, period, person_periods_, roster);
+  ExpectSamePortions(split.GetPortions(), bill_.Split(period, person_periods_, roster));
+
+  std::mt19937 random(42);
+  std::uniform_int_distribution<std::size_t> pos_distribution(0, person_periods_.size() - 1);
+  std::uniform_int_distribution<long> offset_distribution(-30, period.length().days() + 30);
+  std::uniform_int_distribution<std::size_t> person_distribution(0, people_.size());
+  for (unsigned int edit = 0; edit < 200; edit++) {
+    const std::size_t pos = pos_distribution(random);
+    PersonPeriod person_period = person_periods_.at(pos);
+    long start = offset_distribution(random);
+    long end = offset_distribution(random);
+    if (end < start) {
+      std::swap(start, end);
+    }
+    person_period.SetPeriod(boost::gregorian::date_period(period.begin() + boost::gregorian::date_duration(start),
+                                                          period.begin() + boost::gregorian::date_duration(end)));
+    if (edit % 3 == 0) {
+      // Move the period to someone else, sometimes someone not in the roster
+      const std::size_t person = person_distribution(random);
+      person_period.SetName(person < people_.size() ? people_.at(person) : "Stranger");
+    }
+    person_periods_.at(pos) = person_period;
+    split.UpdatePersonPeriod(pos, person_period);
+    ExpectSamePortions(split.GetPortions(), bill_.Split(period, person_periods_, roster));
+    ExpectExactPortions(split.GetPortions(), bill_.Split(period, person_periods_, roster, {SplitMode::kDaily}));
+  }
+
+  BillLine line(Currency::Code::USD);
+  line.amount = Money(99.99, Currency::Code::USD);
+  bill_.AddLine(line);
+  split.SetBill(bill_.Total(), bill_.GetCurrency().code);
+  ExpectSamePortions(split.GetPortions(), bill_.Split(period, person_periods_, roster));
+  EXPECT_THROW(split.SetBill(bill_.Total(), Currency::Code::EUR), std::invalid_argument);
+}
+
+/**
+ * Whole-day time periods at a resolution of a day split the same as dates
+ */
+TEST_F(SplitTest, TimeMatchesDays) {
+  const boost::gregorian::date_period period(boost::gregorian::date(2020, 1, 1), boost::gregorian::date(2020, 4, 1));
+  MakeRoster(period, 12, 40);
+  const Roster roster(people_);
+  const std::vector<PersonTimePeriod> person_time_periods(person_periods_.cbegin(), person_periods_.cend());
+  const boost::posix_time::time_period time_period(boost::posix_time::ptime(period.begin()),
+                                                   boost::posix_time::ptime(period.end()));
+
+  ExpectSamePortions(bill_.Split(time_period, person_time_periods, roster, boost::posix_time::hours(24)),
+                     bill_.Split(period, person_periods_, roster));
+}
+
+/**
+ * Hourly splits match counting every hour, and don't depend on how finely aligned periods are measured
+ */
+TEST_F(SplitTest, TimeHourly) {
+  const boost::posix_time::ptime start(boost::gregorian::date(2020, 1, 1));
+  const boost::posix_time::time_period period(start, start + boost::posix_time::hours(72));
+  const std::vector<std::string> people{"Alice", "Bob", "Carol"};
+  const Roster roster(people);
+  std::mt19937 random(7);
+  std::uniform_int_distribution<long> hour_distribution(-10, 82);
+  std::uniform_int_distribution<std::size_t> person_distribution(0, people.size() - 1);
+  std::vector<PersonTimePeriod> person_periods;
+  for (unsigned int i = 0; i < 10; i++) {
+    long first = hour_distribution(random);
+    long last = hour_distribution(random);
+    if (last < first) {
+      std::swap(first, last);
+    }
+    person_periods.emplace_back(people.at(person_distribution(random)),
+                                boost::posix_time::time_period(start + boost::posix_time::hours(first),
+                                                               start + boost::posix_time::hours(last)));
+  }
+
+  // Count every hour
+  const Money usage_part = bill_.Total().GetUsageTotal() / 72;
+  std::vector<Money> usages(people.size(), Money(0, Currency::Code::USD));
+  for (long hour = 0; hour < 72; hour++) {
+    const boost::posix_time::ptime time = start + boost::posix_time::hours(hour);
+    unsigned int present = 0;
+    for (const auto &person_period : person_periods) {
+      present += person_period.GetPeriod().contains(time);
+    }
+    for (std::size_t person = 0; person < people.size(); person++) {
+      if (present == 0) {
+        usages.at(person) = usages.at(person) + usage_part / people.size();
+      }
+      for (const auto &person_period : person_periods) {
+        if (person_period.GetName() == people.at(person) && person_period.GetPeriod().contains(time)) {
+          usages.at(person) = usages.at(person) + usage_part / present;
+        }
+      }
+    }
+  }
+  std::vector<BillPortion> expected;
+  for (std::size_t person = 0; person < people.size(); person++) {
+    expected.emplace_back(people.at(person), usages.at(person), bill_.Total().GetGeneralTotal() / people.size());
+  }
+
+  ExpectSamePortions(bill_.Split(period, person_periods, roster), expected);
+  ExpectSamePortions(bill_.Split(period, person_periods, roster, boost::posix_time::minutes(1)), expected);
+  ExpectSamePortions(bill_.Split(period, person_periods, roster, boost::posix_time::seconds(1)), expected);
+}
+
+/**
+ * Any part of a unit present counts as the whole unit
+ */
+TEST_F(SplitTest, TimePartialUnits) {
+  const boost::posix_time::ptime start(boost::gregorian::date(2020, 1, 1));
+  const boost::posix_time::time_period period(start, start + boost::posix_time::hours(4));
+  const Roster roster(std::vector<std::string>{"Alice", "Bob"});
+  const std::vector<PersonTimePeriod> person_periods{
+      PersonTimePeriod("Alice", boost::posix_time::time_period(start + boost::posix_time::minutes(15),
+                                                               start + boost::posix_time::minutes(30))),
+  };
+  EXPECT_EQ(GetTimeOffsets(period, person_periods.front().GetPeriod(), boost::posix_time::hours(1)), Offsets(0, 1));
+
+  // Alice is alone for the first hour; the other three are shared.
+  const Money usage = bill_.Total().GetUsageTotal();
+  const std::vector<BillPortion> portions = bill_.Split(period, person_periods, roster);
+  EXPECT_DOUBLE_EQ(portions.at(0).GetUsageTotal().GetValue(), (usage / 4 + usage / 8 * 3).GetValue());
+  EXPECT_DOUBLE_EQ(portions.at(1).GetUsageTotal().GetValue(), (usage / 8 * 3).GetValue());
+
+  EXPECT_THROW((void) bill_.Split(period, person_periods, roster, boost::posix_time::seconds(0)),
+               std::invalid_argument);
+}
+
+/**
+ * Splitting by the second doesn't lose or gain usage to rounding a tiny per-second cost
+ */
+TEST_F(SplitTest, TimeFineResolutionSumsToTotal) {
+  Bill bill(Currency::Code::USD);
+  BillLine usage_line(Currency::Code::USD);
+  usage_line.amount = Money(1000, Currency::Code::USD);
+  bill.AddLine(usage_line);
+  const boost::posix_time::ptime start(boost::gregorian::date(2021, 1, 1));
+  const boost::posix_time::time_period period(start, boost::posix_time::ptime(boost::gregorian::date(2022, 1, 1)));
+  const boost::posix_time::time_duration day = boost::posix_time::hours(24);
+  const Roster roster(std::vector<std::string>{"Alice", "Bob", "Carol"});
+  const std::vector<PersonTimePeriod> person_periods{
+      PersonTimePeriod("Alice", period),
+      PersonTimePeriod("Bob", boost::posix_time::time_period(start + boost::posix_time::seconds(7),
+                                                             start + day * 200 + boost::posix_time::seconds(13))),
+      PersonTimePeriod("Carol", boost::posix_time::time_period(start + day * 100,
+                                                               start + day * 300 + boost::posix_time::seconds(1))),
+  };
+
+  const std::vector<BillPortion> portions = bill.Split(period, person_periods, roster, boost::posix_time::seconds(1));
+  ASSERT_EQ(portions.size(), 3);
+  Money usage(0, Currency::Code::USD);
+  for (const auto &portion : portions) {
+    usage = usage + portion.GetUsageTotal();
+  }
+  // Each segment is rounded once, so only billionths are left over, not most of a cent.
+  const Money error = usage - bill.Total().GetUsageTotal();
+  EXPECT_TRUE(error < 1e-7 && error > -1e-7) << "Portions are off by " << error.GetValue();
+  // Alice is alone for just over 65 days and shares the rest
+  EXPECT_GT(portions.at(0).GetUsageTotal(), portions.at(1).GetUsageTotal());
+}
+
+/**
+ * Repeated splits come from the cache, which keeps the most recently used
+ */
+TEST_F(SplitTest, Cache) {
+  const boost::gregorian::date_period period(boost::gregorian::date(2020, 1, 1), boost::gregorian::date(2020, 2, 1));
+  MakeRoster(period, 5, 12);
+  const Roster roster(people_);
+  const std::vector<BillPortion> expected = bill_.Split(period, person_periods_, roster);
+  SplitCache cache(2);
+
+  ExpectSamePortions(cache.Split(bill_, period, person_periods_, roster), expected);
+  ExpectSamePortions(cache.Split(bill_, period, person_periods_, roster), expected);
+  EXPECT_EQ(cache.GetMissCount(), 1);
+  EXPECT_EQ(cache.GetHitCount(), 1);
+
+  // Only the totals matter, not the lines
+  Bill same_totals(Currency::Code::USD);
+  for (const auto &line : bill_.GetLines()) {
+    BillLine renamed(line);
+    renamed.name = "Renamed";
+    same_totals.AddLine(renamed);
+  }
+  ExpectSamePortions(cache.Split(same_totals, period, person_periods_, roster), expected);
+  EXPECT_EQ(cache.GetHitCount(), 2);
+
+  // Changing any input is a miss
+  std::vector<PersonPeriod> edited(person_periods_);
+  edited.front().SetPeriod(boost::gregorian::date_period(period.begin(), period.end()));
+  ExpectSamePortions(cache.Split(bill_, period, edited, roster), bill_.Split(period, edited, roster));
+  const boost::gregorian::date_period shorter(period.begin(), period.end() - boost::gregorian::date_duration(1));
+  ExpectSamePortions(cache.Split(bill_, shorter, person_periods_, roster),
+                     bill_.Split(shorter, person_periods_, roster));
+  EXPECT_EQ(cache.GetMissCount(), 3);
+  EXPECT_EQ(cache.GetSize(), 2);
+
+  // The first split was least recently used, so it has been dropped.
+  ExpectSamePortions(cache.Split(bill_, period, person_periods_, roster), expected);
+  EXPECT_EQ(cache.GetMissCount(), 4);
+  ExpectSamePortions(cache.Split(bill_, shorter, person_periods_, roster),
+                     bill_.Split(shorter, person_periods_, roster));
+  EXPECT_EQ(cache.GetHitCount(), 3);
+
+  // Each mode gets its own entry, with exactly that mode's portions
+  for (const SplitMode mode : {SplitMode::kDaily, SplitMode::kInterval, SplitMode::kPresenceCalendar}) {
+    const std::vector<BillPortion> mode_expected = bill_.Split(shorter, person_periods_, roster, {mode});
+    ExpectExactPortions(cache.Split(bill_, shorter, person_periods_, roster, {mode}), mode_expected);
+    ExpectExactPortions(cache.Split(bill_, shorter, person_periods_, roster, {mode, 4}), mode_expected);
+  }
+  EXPECT_EQ(cache.GetMissCount(), 6);
+  EXPECT_EQ(cache.GetHitCount(), 7);
+
+  cache.SetCapacity(1);
+  EXPECT_EQ(cache.GetSize(), 1);
+  cache.Clear();
+  EXPECT_EQ(cache.GetSize(), 0);
+  EXPECT_EQ(cache.GetHitCount() + cache.GetMissCount(), 0);
+}